@@ -0,0 +1,350 @@
+/*************************************************************************************[MicroBench.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+// Microbenchmarks of the solver kernels on a single process, without any clause sharing:
+//
+//   propagate        -- replays a captured sequence of decisions on a warmed-up solver.
+//   analyze          -- conflict analysis (including minimization by 'litRedundant()') on the
+//                       conflicts met during the replay.
+//   parse_DIMACS     -- parses the instance from a plain and a gzipped copy.
+//   reduceDB / gc    -- reduces and garbage collects synthetic learnt clause databases.
+//   order heaps      -- the LRB updates of 'cancelUntil()' on the binary 'Heap' and on 'DaryHeap'.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+#include <mpi.h>
+
+#include "../mtl/Sort.h"
+#include "../mtl/Heap.h"
+#include "../mtl/DaryHeap.h"
+#include "../utils/System.h"
+#include "../utils/ParseUtils.h"
+#include "../utils/Options.h"
+#include "../core/Dimacs.h"
+#include "../core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Access to the kernels:
+
+
+struct ActivityGt {
+    const vec<double>& activity;
+    ActivityGt(const vec<double>& act) : activity(act) {}
+    bool operator()(Var x, Var y) const { return activity[x] > activity[y]; }
+};
+
+struct VarOrderGt {
+    bool operator()(double x, double y) const { return x > y; }
+};
+
+class BenchSolver : public Solver {
+public:
+    // Decides the unassigned variables once each, by decreasing activity and with their saved phase,
+    // backtracking one level on each conflict. The decisions are stored in 'decisions' and the solver
+    // is back at level 0.
+    void captureDecisions(vec<Lit>& decisions) {
+        vec<Var> order;
+        for (Var v = 0; v < nVars(); v++)
+            if (decision[v]) order.push(v);
+        sort(order, ActivityGt(activity));
+
+        decisions.clear();
+        for (int i = 0; i < order.size(); i++){
+            if (value(order[i]) != l_Undef) continue;
+            Lit next = mkLit(order[i], polarity[order[i]]);
+            decisions.push(next);
+            newDecisionLevel();
+            uncheckedEnqueue(next);
+            if (propagate() != CRef_Undef)
+                cancelUntil(decisionLevel() - 1);
+        }
+        cancelUntil(0);
+    }
+
+    // Replays 'decisions' as 'captureDecisions()' made them, analyzing the conflicts. Returns the
+    // number of conflicts, and accumulates the ticks spent in 'propagate()' and 'analyze()'.
+    int replay(const vec<Lit>& decisions, uint64_t& propagate_ticks, uint64_t& analyze_ticks) {
+        int      nconfl = 0;
+        vec<Lit> learnt;
+        int      btlevel;
+        for (int i = 0; i < decisions.size(); i++){
+            if (value(decisions[i]) != l_Undef) continue;
+            newDecisionLevel();
+            uncheckedEnqueue(decisions[i]);
+            uint64_t start = cpuTicks();
+            CRef     confl = propagate();
+            propagate_ticks += cpuTicks() - start;
+            if (confl != CRef_Undef){
+                nconfl++;
+                learnt.clear();
+                start = cpuTicks();
+                analyze(confl, learnt, btlevel);
+                analyze_ticks += cpuTicks() - start;
+                cancelUntil(decisionLevel() - 1);
+            }
+        }
+        cancelUntil(0);
+        return nconfl;
+    }
+
+    // Adds 'n' random learnt clauses of sizes 3..'max_size' over the existing variables.
+    void addRandomLearnts(int n, int max_size, uint64_t& seed) {
+        vec<Lit> lits;
+        for (int i = 0; i < n; i++){
+            int size = 3 + next(seed) % (max_size - 2);
+            lits.clear();
+            while (lits.size() < size){
+                Var v = next(seed) % nVars();
+                bool dup = false;
+                for (int j = 0; j < lits.size() && !dup; j++) dup = var(lits[j]) == v;
+                if (!dup) lits.push(mkLit(v, next(seed) & 1)); }
+            CRef cr = ca.alloc(lits, true);
+#if TIERED_CLAUSE_DB
+            initTier(ca[cr], 2 + next(seed) % (size - 1));
+            ca[cr].activity() = (float)(next(seed) % 1000000) / 1000000;
+#elif LBD_BASED_CLAUSE_DELETION
+            ca[cr].activity() = 2 + next(seed) % (size - 1);
+#else
+            ca[cr].activity() = (float)(next(seed) % 1000000) / 1000000;
+#endif
+            learnts.push(cr);
+            attachClause(cr);
+        }
+    }
+
+    void     timedReduceDB()  { reduceDB(); }
+    uint32_t allocatedWords() { return ca.size(); }
+
+private:
+    static uint32_t next(uint64_t& seed) { seed = seed * 6364136223846793005ULL + 1442695040888963407ULL; return seed >> 33; }
+};
+
+
+//=================================================================================================
+// Benchmarks:
+
+
+static IntOption    opt_warmup   ("BENCH", "warmup",   "Conflicts solved before capturing the decisions for propagate/analyze.\n", 20000, IntRange(0, INT32_MAX));
+static IntOption    opt_rounds   ("BENCH", "rounds",   "Replays of the captured decisions.\n", 200, IntRange(1, INT32_MAX));
+static IntOption    opt_parses   ("BENCH", "parses",   "Repetitions of each parse.\n", 20, IntRange(1, INT32_MAX));
+static IntOption    opt_db_vars  ("BENCH", "db-vars",  "Variables of the synthetic clause databases.\n", 100000, IntRange(3, INT32_MAX));
+static IntOption    opt_db_size  ("BENCH", "db-size",  "Learnt clauses in the synthetic clause databases.\n", 200000, IntRange(1, INT32_MAX));
+static IntOption    opt_db_len   ("BENCH", "db-len",   "Maximal length of the synthetic learnt clauses.\n", 30, IntRange(3, INT32_MAX));
+static IntOption    opt_db_reps  ("BENCH", "db-reps",  "Repetitions of reduceDB and garbage collection.\n", 10, IntRange(1, INT32_MAX));
+static IntOption    opt_heap_vars("BENCH", "heap-vars", "Variables of the order heap benchmark.\n", 1000000, IntRange(1, INT32_MAX));
+static IntOption    opt_heap_trail("BENCH", "heap-trail", "Variables assigned and unassigned per round of the order heap benchmark.\n", 5000, IntRange(1, INT32_MAX));
+static IntOption    opt_heap_rounds("BENCH", "heap-rounds", "Rounds of the order heap benchmark.\n", 1000, IntRange(1, INT32_MAX));
+
+static void parseInto(Solver& S, const char* file)
+{
+    gzFile in = gzopen(file, "rb");
+    if (in == NULL) printf("ERROR! Could not open file: %s\n", file), exit(1);
+    parse_DIMACS(in, S);
+    gzclose(in);
+}
+
+static void benchPropagate(const char* file)
+{
+    BenchSolver S;
+    S.verbosity = 0;
+    parseInto(S, file);
+    if (!S.simplify()){ printf("propagate/analyze     : skipped (instance is trivially UNSAT)\n"); return; }
+
+    vec<Lit> dummy;
+    S.setConfBudget(opt_warmup);
+    lbool warm = S.solveLimited(dummy);
+    S.budgetOff();
+    if (warm == l_False){ printf("propagate/analyze     : skipped (UNSAT during warm-up)\n"); return; }
+
+    vec<Lit> decisions;
+    S.captureDecisions(decisions);
+
+    uint64_t props0 = S.propagations, propagate_ticks = 0, analyze_ticks = 0;
+    int      nconfl = 0;
+    uint64_t ticks0 = cpuTicks();
+    double   start  = realTime();
+    for (int r = 0; r < opt_rounds; r++)
+        nconfl += S.replay(decisions, propagate_ticks, analyze_ticks);
+    double   ticks_per_sec = (cpuTicks() - ticks0) / (realTime() - start);
+    double   propagate_time = propagate_ticks / ticks_per_sec, analyze_time = analyze_ticks / ticks_per_sec;
+    uint64_t props = S.propagations - props0;
+    printf("propagate             : %-12.0f props/sec   (%.1f ns/prop, %d decisions, %d conflicts per round, %d learnts)\n",
+           props / propagate_time, propagate_time * 1e9 / props, decisions.size(), nconfl / (int)opt_rounds, S.nLearnts());
+    if (nconfl > 0)
+        printf("analyze               : %-12.0f ns/op       (%d conflicts, ccmin-mode %d)\n", analyze_time * 1e9 / nconfl, nconfl, S.ccmin_mode);
+}
+
+static void benchParse(const char* file)
+{
+    // Plain and gzipped copies of the (possibly compressed) input:
+    const char* plain = "microbench.tmp.cnf";
+    const char* zip   = "microbench.tmp.cnf.gz";
+    gzFile in  = gzopen(file, "rb");
+    FILE*  out = fopen(plain, "wb");
+    gzFile zout = gzopen(zip, "wb");
+    if (in == NULL || out == NULL || zout == NULL) printf("ERROR! Could not copy %s for parsing\n", file), exit(1);
+    char   buf[1 << 16];
+    int    n;
+    long   bytes = 0;
+    while ((n = gzread(in, buf, sizeof(buf))) > 0){
+        fwrite(buf, 1, n, out);
+        gzwrite(zout, buf, n);
+        bytes += n; }
+    gzclose(in); fclose(out); gzclose(zout);
+
+    const char* files[2] = { plain, zip };
+    const char* names[2] = { "parse_DIMACS (plain)  ", "parse_DIMACS (gzip)   " };
+    for (int f = 0; f < 2; f++){
+        uint64_t lits  = 0;
+        double   start = realTime();
+        for (int r = 0; r < opt_parses; r++){
+            Solver S;
+            parseInto(S, files[f]);
+            lits = S.clauses_literals; }
+        double   time  = (realTime() - start) / opt_parses;
+        printf("%s: %-12.1f MB/sec      (%.1f ns/literal, %.3f ms/parse)\n", names[f], bytes / time / 1048576, time * 1e9 / (lits ? lits : 1), time * 1000);
+    }
+    ::remove(plain);
+    ::remove(zip);
+}
+
+static void benchReduceDB()
+{
+    double   reduce_time = 0, gc_time = 0;
+    uint64_t seed = 1, words = 0;
+    for (int r = 0; r < opt_db_reps; r++){
+        BenchSolver S;
+        S.garbage_frac = HUGE_VAL;  // Collect explicitly below, not inside 'reduceDB()'.
+        for (int v = 0; v < opt_db_vars; v++) S.newVar();
+        S.addRandomLearnts(opt_db_size, opt_db_len, seed);
+
+        double start = realTime();
+        S.timedReduceDB();
+        reduce_time += realTime() - start;
+
+        words = S.allocatedWords();
+        start = realTime();
+        S.garbageCollect();
+        gc_time += realTime() - start;
+    }
+    printf("reduceDB              : %-12.3f ms/op       (%.1f ns/clause, %d learnts)\n", reduce_time * 1000 / opt_db_reps, reduce_time * 1e9 / opt_db_reps / opt_db_size, (int)opt_db_size);
+    printf("garbageCollect        : %-12.3f ms/op       (%.2f ns/word, %" PRIu64 " words)\n", gc_time * 1000 / opt_db_reps, gc_time * 1e9 / opt_db_reps / words, words);
+}
+
+// The order heap workload: each round decides the most active variables, takes a random trail that
+// includes them, and backtracks over it, moving the activity of each trail variable towards a random
+// reward and putting it back into the heap as 'cancelUntil()' does with LRB. The same workload runs
+// on the binary 'Heap' ordered through 'activity' and on 'DaryHeap' with keys, updated one by one
+// or in batches.
+static uint32_t nextRand(uint64_t& seed) { seed = seed * 6364136223846793005ULL + 1442695040888963407ULL; return seed >> 33; }
+
+static void heapTrail(vec<Var>& trail, int nvars, int decisions, uint64_t& seed) {
+    trail.shrink(trail.size() - decisions);
+    while (trail.size() < opt_heap_trail)
+        trail.push(nextRand(seed) % nvars); }
+
+static double benchBinaryHeap(vec<double>& activity)
+{
+    Heap<ActivityGt> heap((ActivityGt(activity)));
+    vec<Var>         trail;
+    uint64_t         seed  = 1;
+    for (Var v = 0; v < activity.size(); v++) heap.insert(v);
+
+    double start = realTime();
+    for (int r = 0; r < opt_heap_rounds; r++){
+        trail.clear();
+        for (int i = 0; i < opt_heap_trail / 8 && !heap.empty(); i++) trail.push(heap.removeMin());
+        heapTrail(trail, activity.size(), trail.size(), seed);
+        for (int i = 0; i < trail.size(); i++){
+            Var    x   = trail[i];
+            double old = activity[x];
+            activity[x] = 0.6 * old + 0.4 * (nextRand(seed) % 1000) / 1000;
+            if (!heap.inHeap(x))           heap.insert(x);
+            else if (activity[x] > old)    heap.decrease(x);
+            else                           heap.increase(x); }
+    }
+    return realTime() - start;
+}
+
+template<int D>
+static double benchDaryHeap(vec<double>& activity, bool batched)
+{
+    DaryHeap<double, VarOrderGt, D> heap;
+    vec<Var>                        trail;
+    uint64_t                        seed  = 1;
+    for (Var v = 0; v < activity.size(); v++) heap.insert(v, activity[v]);
+
+    double start = realTime();
+    for (int r = 0; r < opt_heap_rounds; r++){
+        trail.clear();
+        for (int i = 0; i < opt_heap_trail / 8 && !heap.empty(); i++) trail.push(heap.removeMin());
+        heapTrail(trail, activity.size(), trail.size(), seed);
+        for (int i = 0; i < trail.size(); i++){
+            Var x = trail[i];
+            activity[x] = 0.6 * activity[x] + 0.4 * (nextRand(seed) % 1000) / 1000;
+            if (!heap.inHeap(x)) heap.insert(x, activity[x]);
+            else if (batched)    heap.set(x, activity[x]);
+            else                 heap.update(x, activity[x]); }
+        heap.settle();
+    }
+    return realTime() - start;
+}
+
+static void benchOrderHeap()
+{
+    vec<double> init(opt_heap_vars), activity;
+    uint64_t    seed = 2;
+    for (int v = 0; v < init.size(); v++) init[v] = (nextRand(seed) % 1000) / 1000.0;
+
+    const char* names[] = { "Heap (binary)", "DaryHeap<2>", "DaryHeap<4>", "DaryHeap<4> batched", "DaryHeap<8> batched" };
+    for (int k = 0; k < 5; k++){
+        init.copyTo(activity);
+        double time = k == 0 ? benchBinaryHeap(activity)
+                    : k == 1 ? benchDaryHeap<2>(activity, false)
+                    : k == 2 ? benchDaryHeap<4>(activity, false)
+                    : k == 3 ? benchDaryHeap<4>(activity, true)
+                    :          benchDaryHeap<8>(activity, true);
+        printf("order heap            : %-12.1f ns/update   (%s, %d vars, %d per round)\n", time * 1e9 / opt_heap_rounds / opt_heap_trail, names[k], (int)opt_heap_vars, (int)opt_heap_trail);
+    }
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <input-file>\n\n  where input may be either in plain or gzipped DIMACS.\n");
+    parseOptions(argc, argv, true);
+    if (argc != 2) printf("USAGE: %s [options] <input-file>\n", argv[0]), exit(1);
+
+    // The solver kernels do not communicate, but the warm-up search expects MPI to be initialized:
+    MPI_Init(&argc, &argv);
+
+    benchPropagate(argv[1]);
+    benchParse(argv[1]);
+    benchReduceDB();
+    benchOrderHeap();
+
+    MPI_Finalize();
+    return 0;
+}
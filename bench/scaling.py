@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Scaling benchmark: runs maplesat under mpirun with 1, 2, 4, ... N ranks on a set of CNFs.
+
+Every run writes its statistics with -stats-json. The script records one CSV row per run:
+wall time, conflicts/sec per rank, and clause export/import rates. It then prints speedup and
+efficiency tables. Speedup is measured against np=1, using the median wall time over the
+repetitions.
+
+    bench/scaling.py --solver build/maplesat --max-np 8 bench/cnf my/instances/
+"""
+
+import argparse
+import csv
+import glob
+import json
+import math
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+FIELDS = ["instance", "np", "rep", "result", "wall_time", "mpirun_time", "cpu_time", "conflicts",
+          "conflicts_per_sec_rank", "exports_per_sec", "imports_per_sec", "import_accept_pct"]
+
+
+def instances(paths):
+    found = []
+    for p in paths:
+        if os.path.isdir(p):
+            for pattern in ("*.cnf", "*.cnf.gz"):
+                found += glob.glob(os.path.join(p, pattern))
+        else:
+            found.append(p)
+    return sorted(set(found))
+
+
+def rank_counts(max_np):
+    counts, n = [], 1
+    while n < max_np:
+        counts.append(n)
+        n *= 2
+    return counts + [max_np]
+
+
+def run(args, cnf, np_, rep, tmp):
+    stats = os.path.join(tmp, "stats.json")
+    if os.path.exists(stats):
+        os.remove(stats)
+    cmd = [args.mpirun, "-np", str(np_)] + args.mpirun_args.split() + \
+          [args.solver, "-verb=0", "-stats-json=" + stats] + args.solver_args.split() + [cnf]
+    start = time.time()
+    try:
+        subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        pass
+    elapsed = time.time() - start
+
+    row = {"instance": os.path.basename(cnf), "np": np_, "rep": rep, "mpirun_time": "%.3f" % elapsed}
+    if not os.path.exists(stats):
+        row.update(result="TIMEOUT" if elapsed >= args.timeout else "ERROR", wall_time="%.3f" % elapsed)
+        return row
+
+    t = json.load(open(stats))["totals"]
+    wall = max(t["wall_time"], 1e-9)
+    row.update(result=t["result"], wall_time="%.4f" % t["wall_time"], cpu_time="%.4f" % t["cpu_time"],
+               conflicts=t["conflicts"],
+               conflicts_per_sec_rank="%.0f" % (t["conflicts"] / wall / np_),
+               exports_per_sec="%.0f" % (t["clauses_exported"] / wall),
+               imports_per_sec="%.0f" % (t["clauses_imported"] / wall),
+               import_accept_pct="%.1f" % (100.0 * t["clauses_imported"] / t["clauses_received"])
+                                 if t["clauses_received"] else "")
+    return row
+
+
+def table(title, header, rows):
+    widths = [max(len(str(r[i])) for r in [header] + rows) for i in range(len(header))]
+    print("\n" + title)
+    print("  ".join(h.rjust(w) for h, w in zip(header, widths)))
+    for r in rows:
+        print("  ".join(str(c).rjust(w) for c, w in zip(r, widths)))
+
+
+def report(rows, counts):
+    """Prints speedup and efficiency per instance, and their geometric means over all instances
+    solved at every rank count."""
+    median = {}
+    for name in sorted(set(r["instance"] for r in rows)):
+        for n in counts:
+            ok = [float(r["wall_time"]) for r in rows
+                  if r["instance"] == name and r["np"] == n and r["result"] in ("SAT", "UNSAT")]
+            median[name, n] = statistics.median(ok) if ok else None
+
+    names = sorted(set(name for name, _ in median))
+    header = ["instance"] + ["np=%d" % n for n in counts]
+    speedup, efficiency, geo = [], [], {n: [] for n in counts}
+    for name in names:
+        base = median[name, 1]
+        s = [base / median[name, n] if base and median[name, n] else None for n in counts]
+        speedup.append([name] + ["%.2f" % x if x else "-" for x in s])
+        efficiency.append([name] + ["%.2f" % (x / n) if x else "-" for x, n in zip(s, counts)])
+        if all(s):
+            for x, n in zip(s, counts):
+                geo[n].append(x)
+    if geo[1]:
+        g = [math.exp(sum(math.log(x) for x in geo[n]) / len(geo[n])) for n in counts]
+        speedup.append(["geomean"] + ["%.2f" % x for x in g])
+        efficiency.append(["geomean"] + ["%.2f" % (x / n) for x, n in zip(g, counts)])
+
+    table("Median wall time (s)", header,
+          [[name] + ["%.3f" % median[name, n] if median[name, n] else "-" for n in counts] for name in names])
+    table("Speedup (T1 / Tn)", header, speedup)
+    table("Efficiency (speedup / n)", header, efficiency)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    p = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    p.add_argument("paths", nargs="*", default=[os.path.join(here, "cnf")],
+                   help="CNF files or directories of *.cnf / *.cnf.gz (default: the bundled set)")
+    p.add_argument("--solver", default="maplesat", help="maplesat binary")
+    p.add_argument("--mpirun", default="mpirun", help="MPI launcher")
+    p.add_argument("--mpirun-args", default="", help="extra launcher arguments, e.g. '--oversubscribe'")
+    p.add_argument("--solver-args", default="", help="extra solver options, e.g. '-phase-share=5000'")
+    p.add_argument("--max-np", type=int, default=4, help="largest number of ranks (runs 1, 2, 4, ... and this)")
+    p.add_argument("--reps", type=int, default=3, help="repetitions per instance and rank count")
+    p.add_argument("--timeout", type=float, default=300, help="wall-clock limit per run in seconds")
+    p.add_argument("--csv", default="scaling.csv", help="output CSV file")
+    args = p.parse_args()
+
+    cnfs = instances(args.paths)
+    if not cnfs:
+        sys.exit("No instances found in: " + " ".join(args.paths))
+    counts = rank_counts(args.max_np)
+
+    rows = []
+    with tempfile.TemporaryDirectory() as tmp, open(args.csv, "w", newline="") as out:
+        w = csv.DictWriter(out, fieldnames=FIELDS)
+        w.writeheader()
+        for cnf in cnfs:
+            for n in counts:
+                for rep in range(args.reps):
+                    row = run(args, cnf, n, rep, tmp)
+                    w.writerow(row)
+                    out.flush()
+                    rows.append(row)
+                    print("%-28s np=%-3d rep=%d  %-7s %8ss" % (row["instance"], n, rep, row["result"], row["wall_time"]),
+                          file=sys.stderr)
+
+    report(rows, counts)
+    print("\nWrote %s" % args.csv)
+
+
+if __name__ == "__main__":
+    main()
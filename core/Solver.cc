@@ -23,8 +23,12 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <mpi.h>
 #include <iostream>
 #include <set>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
 #include "../mtl/Sort.h"
 #include "../core/Solver.h"
+#include "../utils/System.h"
 
 using namespace Minisat;
 
@@ -39,25 +43,57 @@ static DoubleOption  opt_step_size         (_cat, "step-size",   "Initial step s
 static DoubleOption  opt_step_size_dec     (_cat, "step-size-dec","Step size decrement",                          0.000001, DoubleRange(0, false, 1, false));
 static DoubleOption  opt_min_step_size     (_cat, "min-step-size","Minimal step size",                            0.06,     DoubleRange(0, false, 1, false));
 #endif
-#if BRANCHING_HEURISTIC == VSIDS
+#if BRANCHING_HEURISTIC == VSIDS || STABLE_MODE
 static DoubleOption  opt_var_decay         (_cat, "var-decay",   "The variable activity decay factor",            0.95,     DoubleRange(0, false, 1, false));
 #endif
-#if ! LBD_BASED_CLAUSE_DELETION
+#if CLAUSE_ACTIVITY
 static DoubleOption  opt_clause_decay      (_cat, "cla-decay",   "The clause activity decay factor",              0.999,    DoubleRange(0, false, 1, false));
 #endif
 static DoubleOption  opt_random_var_freq   (_cat, "rnd-freq",    "The frequency with which the decision heuristic tries to choose a random variable", 0, DoubleRange(0, true, 1, true));
 static DoubleOption  opt_random_seed       (_cat, "rnd-seed",    "Used by the random variable selection",         91648253, DoubleRange(0, false, HUGE_VAL, false));
 static IntOption     opt_ccmin_mode        (_cat, "ccmin-mode",  "Controls conflict clause minimization (0=none, 1=basic, 2=deep)", 2, IntRange(0, 2));
+static IntOption     opt_bin_min_lbd       (_cat, "bin-min-lbd", "Also minimize learnt clauses up to this LBD with the binary clauses (0=never)", 6, IntRange(0, INT32_MAX));
+static IntOption     opt_bin_min_size      (_cat, "bin-min-size", "Maximal size of the learnt clauses minimized with the binary clauses", 30, IntRange(2, INT32_MAX));
 static IntOption     opt_phase_saving      (_cat, "phase-saving", "Controls the level of phase saving (0=none, 1=limited, 2=full)", 2, IntRange(0, 2));
 static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the initial activity", false);
 static BoolOption    opt_luby_restart      (_cat, "luby",        "Use the Luby restart sequence", true);
+static IntOption     opt_restart_mode      (_cat, "restart-mode", "Restarts (0=luby/geometric sequence, 1=dynamic on LBD averages, 2=dynamic on the odd ranks)", 0, IntRange(0, 2));
+static DoubleOption  opt_restart_k         (_cat, "restart-k",   "Dynamic restart when the recent LBD average times this exceeds the global one", 0.8, DoubleRange(0, false, HUGE_VAL, false));
+static DoubleOption  opt_block_r           (_cat, "block-r",     "Postpone a dynamic restart when the trail exceeds its average by this factor", 1.4, DoubleRange(1, false, HUGE_VAL, false));
+static IntOption     opt_block_start       (_cat, "block-start", "Conflicts before dynamic restarts may be postponed", 10000, IntRange(0, INT32_MAX));
+static IntOption     opt_vmtf_mode         (_cat, "vmtf-mode",   "Decision order in the focused mode (0=heap of the branching scores, 1=VMTF queue, 2=VMTF on the odd ranks)", 0, IntRange(0, 2));
+static BoolOption    opt_reuse_trail       (_cat, "reuse-trail", "Keep the decisions more active than the next decision on restarts", false);
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
+#if STABLE_MODE
+static IntOption     opt_mode_int          (_cat, "mode-int",    "Conflicts of the first focused (LRB) mode before a stable (VSIDS) one (0=never switch)", 0, IntRange(0, INT32_MAX));
+static DoubleOption  opt_mode_inc          (_cat, "mode-inc",    "Growth of the mode lengths after each focused and stable mode", 2, DoubleRange(1, true, HUGE_VAL, false));
+static IntOption     opt_stable_restart    (_cat, "stable-restart", "Unit of the luby restart sequence in the stable mode", 1024, IntRange(1, INT32_MAX));
+#endif
+static IntOption     opt_rephase_int       (_cat, "rephase-int", "Conflicts before the first rephasing, and increment of the interval after each (0=never)", 1000, IntRange(0, INT32_MAX));
+static DoubleOption  opt_walk_eff          (_cat, "walk-eff",    "Clause visits of a rephasing walk, relative to the propagations of the search since the last one (0=no walks)", 0.5, DoubleRange(0, true, HUGE_VAL, false));
+static IntOption     opt_chrono            (_cat, "chrono",      "Backtrack chronologically when a backjump would undo more than this many levels (-1=never)", -1, IntRange(-1, INT32_MAX));
+static IntOption     opt_confl_to_chrono   (_cat, "confl-to-chrono", "Conflicts before chronological backtracking starts", 4000, IntRange(0, INT32_MAX));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+#if TIERED_CLAUSE_DB
+static IntOption     opt_core_lbd          (_cat, "core-lbd",    "Learnt clauses up to this LBD are never deleted", 2, IntRange(1, INT32_MAX));
+static IntOption     opt_tier2_lbd         (_cat, "tier2-lbd",   "Learnt clauses up to this LBD are kept while they are used", 6, IntRange(1, INT32_MAX));
+static IntOption     opt_tier2_keep        (_cat, "tier2-keep",  "Conflicts without use after which a mid-tier learnt clause may be deleted", 5000, IntRange(0, INT32_MAX));
+static IntOption     opt_reduce_int        (_cat, "reduce-int",  "Conflicts between two reductions of the local learnt clauses", 2000, IntRange(1, INT32_MAX));
+static IntOption     opt_vivify_int        (_cat, "vivify-int",  "Conflicts between two vivifications of the core and mid-tier learnt clauses (0=never)", 2000, IntRange(0, INT32_MAX));
+static DoubleOption  opt_vivify_eff        (_cat, "vivify-eff",  "Propagations a vivification may spend, relative to the search since the last one", 0.1, DoubleRange(0, false, HUGE_VAL, false));
+#endif
 #if BRANCHING_HEURISTIC == CHB
 static DoubleOption  opt_reward_multiplier (_cat, "reward-multiplier", "Reward multiplier", 0.9, DoubleRange(0, true, 1, true));
 #endif
 
+static const char* _par = "PARALLEL";
+
+static IntOption     opt_phase_share_int   (_par, "phase-share", "Conflicts (flips on local search ranks) between best-phase exchanges with the other ranks (0=off)", 0, IntRange(0, INT32_MAX));
+static BoolOption    opt_phase_import      (_par, "phase-import", "Seed the saved phases from a better best phase of another rank", true);
+static IntOption     opt_walkers           (_par, "walkers",      "Number of ranks (the last ones, never rank 0) that run local search instead of CDCL", 0, IntRange(0, INT32_MAX));
+static IntOption     opt_det_epoch         (_par, "det-epoch",    "Exchange clauses only every this many conflicts, synchronously, for a reproducible search (0=asynchronous)", 0, IntRange(0, INT32_MAX));
+
 
 //=================================================================================================
 // Constructor/Destructor:
@@ -73,16 +109,24 @@ Solver::Solver() :
   , step_size_dec    (opt_step_size_dec)
   , min_step_size    (opt_min_step_size)
 #endif
-#if BRANCHING_HEURISTIC == VSIDS
+#if BRANCHING_HEURISTIC == VSIDS || STABLE_MODE
   , var_decay        (opt_var_decay)
 #endif
-#if ! LBD_BASED_CLAUSE_DELETION
+#if CLAUSE_ACTIVITY
   , clause_decay     (opt_clause_decay)
 #endif
   , random_var_freq  (opt_random_var_freq)
   , random_seed      (opt_random_seed)
   , luby_restart     (opt_luby_restart)
+  , restart_mode     (opt_restart_mode)
+  , restart_k        (opt_restart_k)
+  , block_r          (opt_block_r)
+  , block_start      (opt_block_start)
+  , reuse_trail      (opt_reuse_trail)
+  , vmtf_mode        (opt_vmtf_mode)
   , ccmin_mode       (opt_ccmin_mode)
+  , bin_min_lbd      (opt_bin_min_lbd)
+  , bin_min_size     (opt_bin_min_size)
   , phase_saving     (opt_phase_saving)
   , rnd_pol          (false)
   , rnd_init_act     (opt_rnd_init_act)
@@ -98,11 +142,31 @@ Solver::Solver() :
     //
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
+#if TIERED_CLAUSE_DB
+  , core_lbd                      (opt_core_lbd)
+  , tier2_lbd                     (opt_tier2_lbd)
+  , tier2_keep                    (opt_tier2_keep)
+  , reduce_int                    (opt_reduce_int)
+  , vivify_int                    (opt_vivify_int)
+  , vivify_eff                    (opt_vivify_eff)
+#endif
+  , checkpoint_int                (0)
+#if STABLE_MODE
+  , mode_int                      (opt_mode_int)
+  , mode_inc                      (opt_mode_inc)
+  , stable_restart                (opt_stable_restart)
+#endif
+  , rephase_int                   (opt_rephase_int)
+  , walk_eff                      (opt_walk_eff)
+  , chrono                        (opt_chrono)
+  , confl_to_chrono               (opt_confl_to_chrono)
 
     // Statistics: (formerly in 'SolverStats')
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , clauses_exported(0), clauses_received(0), clauses_imported(0)
+  , chrono_backtracks(0), reused_levels(0), bin_min_lits(0), blocked_restarts(0), mode_switches(0), rephases(0), walk_flips(0), vivified_clauses(0), vivified_lits(0)
 
   , lbd_calls(0)
 #if BRANCHING_HEURISTIC == CHB
@@ -110,28 +174,74 @@ Solver::Solver() :
   , reward_multiplier(opt_reward_multiplier)
 #endif
 
+  , Comm_size          (1)
+  , Mpi_rank           (0)
+  , iterations         (0)
+  , phase_share_int    (opt_phase_share_int)
+  , phase_import       (opt_phase_import)
+  , walkers            (opt_walkers)
+  , phase_exports      (0)
+  , phase_imports      (0)
+  , peer_stop          (false)
+  , det_epoch          (opt_det_epoch)
+  , det_epochs         (0)
+  , det_sync_time      (0)
+  , det_winner         (-1)
+
   , ok                 (true)
-#if ! LBD_BASED_CLAUSE_DELETION
+#if CLAUSE_ACTIVITY
   , cla_inc            (1)
 #endif
-#if BRANCHING_HEURISTIC == VSIDS
+#if BRANCHING_HEURISTIC == VSIDS || STABLE_MODE
   , var_inc            (1)
 #endif
   , watches            (WatcherDeleted(ca))
+  , watches_bin        (WatcherDeleted(ca))
   , qhead              (0)
   , simpDB_assigns     (-1)
   , simpDB_props       (0)
-  , order_heap         (VarOrderLt(activity))
+  , order_heap         (VarOrderLt())
   , progress_estimate  (0)
   , remove_satisfied   (true)
+  , lbd_fast           (1.0 / 32)
+  , lbd_slow           (1.0 / 16384)
+  , trail_avg          (1.0 / 4096)
+  , dyn_restarts       (false)
 
     // Resource constraints:
     //
   , conflict_budget    (-1)
   , propagation_budget (-1)
   , asynch_interrupt   (false)
-  , iterations         (0)
-{}
+  , checkpoint_requested (false)
+  , next_checkpoint    (0)
+  , resumed            (false)
+  , best_trail         (0)
+  , best_falsified     (-1)
+  , walker_imported    (UINT32_MAX)
+  , next_rephase       (0)
+  , walk_props         (0)
+  , stable             (false)
+#if STABLE_MODE
+  , target_trail       (0)
+  , next_switch        (0)
+  , mode_len           (0)
+#endif
+  , vmtf               (false)
+  , queue_first        (var_Undef)
+  , queue_last         (var_Undef)
+  , queue_search       (var_Undef)
+  , queue_stamps       (0)
+  , next_phase_share   (0)
+  , stops_received     (0)
+  , stop_sendbuf       (0)
+  , next_epoch         (0)
+  , epoch_stopped      (false)
+{
+    for (int t = 0; t < T_NTIMERS; t++) timer_ticks[t] = timer_calls[t] = 0;
+    timer_ticks0 = cpuTicks();
+    timer_wall0  = realTime();
+}
 
 
 Solver::~Solver()
@@ -151,12 +261,23 @@ Var Solver::newVar(bool sign, bool dvar)
     int v = nVars();
     watches  .init(mkLit(v, false));
     watches  .init(mkLit(v, true ));
+    watches_bin.init(mkLit(v, false));
+    watches_bin.init(mkLit(v, true ));
     assigns  .push(l_Undef);
+#if VECTOR_WATCH_SCAN
+    if ((v & 15) == 0) false_lits.push(0);
+#endif
     vardata  .push(mkVarData(CRef_Undef, 0));
     //activity .push(0);
     activity .push(rnd_init_act ? drand(random_seed) * 0.00001 : 0);
     seen     .push(0);
     polarity .push(sign);
+    best_polarity.push(sign);
+    original_polarity.push(sign);
+#if STABLE_MODE
+    other_activity.push(0);
+    target_polarity.push(sign);
+#endif
     decision .push();
     trail    .capacity(v+1);
     lbd_seen.push(0);
@@ -173,6 +294,13 @@ Var Solver::newVar(bool sign, bool dvar)
 #endif
     total_actual_rewards.push(0);
     total_actual_count.push(0);
+    queue_links.push(QueueLink());
+    queue_links[v].prev = queue_last;
+    queue_links[v].next = var_Undef;
+    if (queue_last != var_Undef) queue_links[queue_last].next = v; else queue_first = v;
+    queue_last = v;
+    queue_stamp.push(++queue_stamps);
+    queue_search = v;
     setDecisionVar(v, dvar);
     return v;
 }
@@ -211,8 +339,9 @@ bool Solver::addClause_(vec<Lit>& ps)
 void Solver::attachClause(CRef cr) {
     const Clause& c = ca[cr];
     assert(c.size() > 1);
-    watches[~c[0]].push(Watcher(cr, c[1]));
-    watches[~c[1]].push(Watcher(cr, c[0]));
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws = c.size() == 2 ? watches_bin : watches;
+    ws[~c[0]].push(Watcher(cr, c[1]));
+    ws[~c[1]].push(Watcher(cr, c[0]));
     if (c.learnt()) learnts_literals += c.size();
     else            clauses_literals += c.size(); }
 
@@ -220,14 +349,15 @@ void Solver::attachClause(CRef cr) {
 void Solver::detachClause(CRef cr, bool strict) {
     const Clause& c = ca[cr];
     assert(c.size() > 1);
-    
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws = c.size() == 2 ? watches_bin : watches;
+
     if (strict){
-        remove(watches[~c[0]], Watcher(cr, c[1]));
-        remove(watches[~c[1]], Watcher(cr, c[0]));
+        remove(ws[~c[0]], Watcher(cr, c[1]));
+        remove(ws[~c[1]], Watcher(cr, c[0]));
     }else{
         // Lazy detaching: (NOTE! Must clean all watcher lists before garbage collecting this clause)
-        watches.smudge(~c[0]);
-        watches.smudge(~c[1]);
+        ws.smudge(~c[0]);
+        ws.smudge(~c[1]);
     }
 
     if (c.learnt()) learnts_literals -= c.size();
@@ -238,7 +368,9 @@ void Solver::removeClause(CRef cr) {
     Clause& c = ca[cr];
     detachClause(cr);
     // Don't leave pointers to free'd memory!
-    if (locked(c)) vardata[var(c[0])].reason = CRef_Undef;
+    if (locked(c)){
+        Lit implied = c.size() != 2 ? c[0] : (value(c[0]) == l_True ? c[0] : c[1]);
+        vardata[var(implied)].reason = CRef_Undef; }
     c.mark(1); 
     ca.free(cr);
 }
@@ -251,28 +383,37 @@ bool Solver::satisfied(const Clause& c) const {
     return false; }
 
 
-// Revert to the state at given level (keeping all assignment at 'level' but not beyond).
+// Revert to the state at given level (keeping all assignment at 'level' but not beyond). After a
+// chronological backtrack the trail may hold literals above 'trail_lim[level]' that were assigned at
+// 'level' or below; those are kept and put back on the trail, to be propagated again.
 //
 void Solver::cancelUntil(int level) {
     if (decisionLevel() > level){
+        if (phase_share_int > 0 || rephase_int > 0)
+            saveBestPhase();
+#if STABLE_MODE
+        if (stable)
+            saveTargetPhase();
+#endif
+        add_tmp.clear();
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var      x  = var(trail[c]);
+            if (vardata[x].level <= level){
+                add_tmp.push(trail[c]);
+                continue; }
             uint64_t age = conflicts - picked[x];
             if (age > 0) {
                 double reward = ((double) conflicted[x]) / ((double) age);
 #if BRANCHING_HEURISTIC == LRB
+                if (!stable && !vmtf){
 #if ALMOST_CONFLICT
-                double adjusted_reward = ((double) (conflicted[x] + almost_conflicted[x])) / ((double) age);
+                    double adjusted_reward = ((double) (conflicted[x] + almost_conflicted[x])) / ((double) age);
 #else
-                double adjusted_reward = reward;
-#endif
-                double old_activity = activity[x];
-                activity[x] = step_size * adjusted_reward + ((1 - step_size) * old_activity);
-                if (order_heap.inHeap(x)) {
-                    if (activity[x] > old_activity)
-                        order_heap.decrease(x);
-                    else
-                        order_heap.increase(x);
+                    double adjusted_reward = reward;
+#endif
+                    activity[x] = step_size * adjusted_reward + ((1 - step_size) * activity[x]);
+                    if (order_heap.inHeap(x))
+                        order_heap.set(x, activity[x]);     // (applied below, in one batch)
                 }
 #endif
                 total_actual_rewards[x] += reward;
@@ -282,12 +423,19 @@ void Solver::cancelUntil(int level) {
             canceled[x] = conflicts;
 #endif
             assigns [x] = l_Undef;
+#if VECTOR_WATCH_SCAN
+            false_lits[x >> 4] &= ~(3u << ((x & 15) * 2));
+#endif
             if (phase_saving > 1 || (phase_saving == 1) && c > trail_lim.last())
                 polarity[x] = sign(trail[c]);
             insertVarOrder(x); }
+        order_heap.settle();
         qhead = trail_lim[level];
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
+        for (int i = add_tmp.size() - 1; i >= 0; i--)
+            trail.push_(add_tmp[i]);
+        add_tmp.clear();
     } }
 
 
@@ -305,6 +453,10 @@ Lit Solver::pickBranchLit()
         if (value(next) == l_Undef && decision[next])
             rnd_decisions++; }
 
+    // VMTF decision:
+    if ((next == var_Undef || value(next) != l_Undef || !decision[next]) && vmtf && !stable)
+        next = nextQueued();
+
     // Activity based decision:
     while (next == var_Undef || value(next) != l_Undef || !decision[next])
         if (order_heap.empty()){
@@ -313,12 +465,12 @@ Lit Solver::pickBranchLit()
         } else {
 #if ANTI_EXPLORATION
             next = order_heap[0];
-            uint64_t age = conflicts - canceled[next];
+            uint64_t age = stable ? 0 : conflicts - canceled[next];
             while (age > 0) {
                 double decay = pow(0.95, age);
                 activity[next] *= decay;
                 if (order_heap.inHeap(next)) {
-                    order_heap.increase(next);
+                    order_heap.update(next, activity[next]);
                 }
                 canceled[next] = conflicts;
                 next = order_heap[0];
@@ -328,9 +480,288 @@ Lit Solver::pickBranchLit()
             next = order_heap.removeMin();
         }
 
-    return next == var_Undef ? lit_Undef : mkLit(next, rnd_pol ? drand(random_seed) < 0.5 : polarity[next]);
+#if STABLE_MODE
+    const vec<char>& phase = stable ? target_polarity : polarity;
+#else
+    const vec<char>& phase = polarity;
+#endif
+    return next == var_Undef ? lit_Undef : mkLit(next, rnd_pol ? drand(random_seed) < 0.5 : phase[next]);
+}
+
+// The VMTF queue is searched backwards from 'queue_search', which is left at the variable found.
+//
+Var Solver::nextQueued()
+{
+    Var next = queue_search;
+    while (next != var_Undef && (value(next) != l_Undef || !decision[next]))
+        next = queue_links[next].prev;
+    queue_search = next != var_Undef ? next : queue_first;
+    return next;
+}
+
+// Restarting would make the same decisions again, in order, as long as they are more active than
+// the variable at the top of the decision heap. Returns the level of the last such decision (above
+// the assumptions), so that the trail up to it can be kept.
+//
+int Solver::reusedTrailLevel()
+{
+    int level = assumptions.size() < decisionLevel() ? assumptions.size() : decisionLevel();
+    if (vmtf && !stable){
+        Var next = nextQueued();
+        if (next == var_Undef)
+            return 0;
+        while (level < decisionLevel() && queue_stamp[var(trail[trail_lim[level]])] > queue_stamp[next])
+            level++;
+        return level; }
+
+    while (!order_heap.empty() && (value(order_heap[0]) != l_Undef || !decision[order_heap[0]]))
+        order_heap.removeMin();
+    if (order_heap.empty())
+        return 0;
+
+    double next_act = activity[order_heap[0]];
+    while (level < decisionLevel() && activity[var(trail[trail_lim[level]])] > next_act)
+        level++;
+    return level;
 }
 
+/*_________________________________________________________________________________________________
+|
+|  rephase : ()  ->  [bool]
+|  
+|  Description:
+|    Resets the saved phases to, in turn: the best phase, a walk from the best phase, the original
+|    phases, the best phase, a walk, the inverted original phases, the best phase, a walk, random
+|    phases. Phase saving alone keeps the search near the assignments it has seen last; going back
+|    to the best phase, or away from all of them, gets it unstuck. The best and target phases are
+|    recorded afresh afterwards. Returns FALSE if the formula is found UNSAT at level 0.
+|________________________________________________________________________________________________@*/
+bool Solver::rephase()
+{
+    assert(decisionLevel() == 0);
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    static const char schedule[] = "BWOBWIBWR";
+    switch (schedule[rephases++ % (sizeof(schedule) - 1)]){
+    case 'B':
+        if (best_trail > 0) best_polarity.copyTo(polarity);
+        break;
+    case 'W':
+        if (walk_eff > 0) walk((uint64_t)(walk_eff * (propagations - walk_props)));
+        walk_props = propagations;
+        break;
+    case 'O':
+        original_polarity.copyTo(polarity);
+        break;
+    case 'I':
+        for (Var v = 0; v < nVars(); v++) polarity[v] = !original_polarity[v];
+        break;
+    case 'R':
+        for (Var v = 0; v < nVars(); v++) polarity[v] = irand(random_seed, 2);
+        break;
+    }
+
+    best_trail = 0;
+#if STABLE_MODE
+    polarity.copyTo(target_polarity);
+    target_trail = 0;
+#endif
+    next_rephase = conflicts + (uint64_t)rephase_int * (rephases + 1);
+    return true;
+}
+
+/*_________________________________________________________________________________________________
+|
+|  walk : (ticks : uint64_t)  ->  [int]
+|  
+|  Description:
+|    ProbSAT local search over the problem clauses not satisfied at level 0, starting from the saved
+|    phases. Each step flips a variable of a random falsified clause, picked with a probability that
+|    falls polynomially with its break count (the clauses that only it satisfies). The search stops
+|    when no clause is falsified or after 'ticks' occurrence visits. The saved phases become the best
+|    assignment met; returns its number of falsified clauses (0 = a model of the problem clauses).
+|________________________________________________________________________________________________@*/
+int Solver::walk(uint64_t ticks)
+{
+    assert(decisionLevel() == 0);
+
+    // The clauses without their literals false at level 0, flattened:
+    vec<Lit> lits;
+    vec<int> start;
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (satisfied(c)) continue;
+        start.push(lits.size());
+        for (int j = 0; j < c.size(); j++)
+            if (value(c[j]) == l_Undef)
+                lits.push(c[j]); }
+    int nc = start.size();
+    start.push(lits.size());
+
+    // Occurrence lists, flattened and indexed by 'toInt(lit)':
+    vec<int> occ_start(2*nVars() + 1, 0), occ(lits.size()), fill;
+    for (int i = 0; i < lits.size(); i++)
+        occ_start[toInt(lits[i]) + 1]++;
+    for (int i = 1; i < occ_start.size(); i++)
+        occ_start[i] += occ_start[i-1];
+    occ_start.copyTo(fill);
+    for (int c = 0; c < nc; c++)
+        for (int k = start[c]; k < start[c+1]; k++)
+            occ[fill[toInt(lits[k])]++] = c;
+
+    // The literal 'mkLit(v, polarity[v])' is true. 'numtrue' counts the true literals of each clause,
+    // and 'falsified' lists the clauses without any ('pos' is the index of a clause in it):
+    vec<int> numtrue(nc, 0), pos(nc, -1), falsified;
+    for (int c = 0; c < nc; c++){
+        for (int k = start[c]; k < start[c+1]; k++)
+            numtrue[c] += sign(lits[k]) == polarity[var(lits[k])];
+        if (numtrue[c] == 0){
+            pos[c] = falsified.size();
+            falsified.push(c); } }
+
+    // Weights of the break counts, (1 + break)^-2.38 (ProbSAT's polynomial break for 3-SAT):
+    static const int max_break = 16;
+    double break_weight[max_break + 1];
+    for (int b = 0; b <= max_break; b++)
+        break_weight[b] = pow(1.0 + b, -2.38);
+
+    int         best = falsified.size();
+    vec<Var>    flipped;                // Flips since the best assignment.
+    vec<double> weights;
+    uint64_t    visits = 0;
+    while (falsified.size() > 0 && visits < ticks){
+        int    c   = falsified[irand(random_seed, falsified.size())];
+        double sum = 0;
+        weights.clear();
+        for (int k = start[c]; k < start[c+1]; k++){
+            int t = toInt(~lits[k]), brk = 0;
+            for (int o = occ_start[t]; o < occ_start[t+1]; o++)
+                brk += numtrue[occ[o]] == 1;
+            visits += occ_start[t+1] - occ_start[t];
+            weights.push(break_weight[brk < max_break ? brk : max_break]);
+            sum += weights.last(); }
+
+        int i = 0;
+        for (double r = drand(random_seed) * sum; i < weights.size() - 1 && (r -= weights[i]) > 0; i++);
+        Lit p = lits[start[c] + i];
+
+        // Flip the variable of 'p', making 'p' true:
+        for (int o = occ_start[toInt(p)]; o < occ_start[toInt(p)+1]; o++){
+            int d = occ[o];
+            if (numtrue[d]++ == 0){
+                int q = pos[d];
+                falsified[q] = falsified.last();
+                pos[falsified[q]] = q;
+                falsified.pop();
+                pos[d] = -1; } }
+        for (int o = occ_start[toInt(~p)]; o < occ_start[toInt(~p)+1]; o++){
+            int d = occ[o];
+            if (--numtrue[d] == 0){
+                pos[d] = falsified.size();
+                falsified.push(d); } }
+        visits += occ_start[toInt(p)+1] - occ_start[toInt(p)] + occ_start[toInt(~p)+1] - occ_start[toInt(~p)];
+        polarity[var(p)] = sign(p);
+        walk_flips++;
+
+        if (falsified.size() < best){
+            best = falsified.size();
+            flipped.clear();
+        }else
+            flipped.push(var(p));
+    }
+
+    // Back to the best assignment:
+    for (int i = 0; i < flipped.size(); i++)
+        polarity[flipped[i]] = !polarity[flipped[i]];
+    return best;
+}
+
+/*_________________________________________________________________________________________________
+|
+|  localSearch : ()  ->  [lbool]
+|  
+|  Description:
+|    Runs 'walk()' in rounds until it finds a model, continuing each round from the best assignment
+|    of the previous one. Between rounds the clauses of the CDCL ranks are drained unread, and with
+|    'phase_share_int' set, every 'phase_share_int' flips, an assignment with fewer falsified
+|    clauses than the last one published is published as a phase, and the phase of another local
+|    search rank with fewer falsified clauses is picked up. A model is put on the trail like one
+|    found by 'search()'. Never proves UNSAT beyond level 0; returns 'l_Undef' when the budget runs
+|    out or the search is interrupted.
+|________________________________________________________________________________________________@*/
+lbool Solver::localSearch()
+{
+    assert(decisionLevel() == 0);
+    if (!ok || propagate() != CRef_Undef)
+        return l_False;
+
+    static const uint64_t round_ticks = 1 << 24;
+    vec<int> recv_buffer;
+    int      published = INT32_MAX;
+    next_phase_share   = walk_flips + phase_share_int;
+    for (;;){
+        int falsified = walk(round_ticks);
+        if (falsified == 0){
+            newDecisionLevel();
+            for (Var v = 0; v < nVars(); v++)
+                if (decision[v] && value(v) == l_Undef)
+                    uncheckedEnqueue(mkLit(v, polarity[v]));
+            return l_True; }
+
+        for (int flag = 1; flag;){
+            MPI_Status status;
+            MPI_Iprobe(MPI_ANY_SOURCE, TAG_CLAUSE, MPI_COMM_WORLD, &flag, &status);
+            if (flag){
+                int len;
+                MPI_Get_count(&status, MPI_INT, &len);
+                recv_buffer.growTo(len);
+                MPI_Recv((int*)recv_buffer, len, MPI_INT, status.MPI_SOURCE, TAG_CLAUSE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                clauses_received++; } }
+
+        if (phase_share_int > 0 && Comm_size > 1 && walk_flips >= next_phase_share){
+            if (falsified < published){
+                polarity.copyTo(best_polarity);
+                best_falsified = published = falsified; }
+            sharePhase(falsified);
+            next_phase_share = walk_flips + phase_share_int; }
+
+        if (peer_stop) pollStop();
+        if (!withinBudget()) return l_Undef;
+    }
+}
+
+#if STABLE_MODE
+/*_________________________________________________________________________________________________
+|
+|  switchMode : ()  ->  [void]
+|  
+|  Description:
+|    Switches between the focused mode (LRB scores or the VMTF queue, saved phases, the restarts of
+|    'restart_mode') and the stable mode (VSIDS scores, target phases, luby restarts in units of
+|    'stable_restart').
+|    The scores of the mode left are kept for its next turn. A stable mode lasts as long as the
+|    focused mode before it; each focused mode is 'mode_inc' times longer than the previous one.
+|________________________________________________________________________________________________@*/
+void Solver::switchMode()
+{
+    assert(decisionLevel() == 0);
+    vec<double> tmp;
+    activity.moveTo(tmp);
+    other_activity.moveTo(activity);
+    tmp.moveTo(other_activity);
+    rebuildOrderHeap();
+
+    stable = !stable;
+    if (!stable){
+        mode_len    *= mode_inc;
+        queue_search = queue_last; }
+    next_switch  = conflicts + (uint64_t)mode_len;
+    target_trail = 0;
+    mode_switches++;
+}
+#endif
+
 /*_________________________________________________________________________________________________
 |
 |  analyze : (confl : Clause*) (out_learnt : vec<Lit>&) (out_btlevel : int&)  ->  [void]
@@ -350,6 +781,7 @@ Lit Solver::pickBranchLit()
 |________________________________________________________________________________________________@*/
 void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 {
+    TIMER_START(T_ANALYZE);
     int pathC = 0;
     Lit p     = lit_Undef;
 
@@ -357,12 +789,34 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     //
     out_learnt.push();      // (leave room for the asserting literal)
     int index   = trail.size() - 1;
+    // With chronological backtracking the conflict may be below the current decision level
+    // ('findConflictLevel()' has moved the literal of the conflict level first):
+    int confl_level = chrono >= 0 ? level(var(ca[confl][0])) : decisionLevel();
 
     do{
         assert(confl != CRef_Undef); // (otherwise should be UIP)
-        Clause& c = ca[confl];
+        Clause& c = p == lit_Undef ? ca[confl] : reasonClause(var(p));
+#if CLAUSE_TRACKING || SHARED_CLAUSE_USE_PER
+        markSharedUsed(c);
+#endif
 
-#if LBD_BASED_CLAUSE_DELETION
+#if TIERED_CLAUSE_DB
+        // Clauses whose LBD improves move up a tier; used clauses stay in theirs:
+        if (c.learnt() && c.tier() != TIER_CORE){
+            int l = lbd(c);
+            if (l < c.lbd()){
+                c.lbd(l);
+                if (l <= core_lbd)
+                    c.tier(TIER_CORE);
+                else if (l <= tier2_lbd && c.tier() == TIER_LOCAL)
+                    c.tier(TIER_MID);
+            }
+            if (c.tier() == TIER_MID)
+                c.touched() = conflicts;
+            else if (c.tier() == TIER_LOCAL)
+                claBumpActivity(c);
+        }
+#elif LBD_BASED_CLAUSE_DELETION
         if (c.learnt() && c.activity() > 2)
             c.activity() = lbd(c);
 #else
@@ -378,19 +832,24 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
                 last_conflict[var(q)] = conflicts;
 #elif BRANCHING_HEURISTIC == VSIDS
                 varBumpActivity(var(q));
+#elif STABLE_MODE
+                if (stable) varBumpActivity(var(q));
 #endif
                 conflicted[var(q)]++;
+                if (vmtf && !stable) queue_bumped.push(var(q));
                 seen[var(q)] = 1;
-                if (level(var(q)) >= decisionLevel())
+                if (level(var(q)) >= confl_level)
                     pathC++;
                 else
                     out_learnt.push(q);
             }
         }
         
-        // Select next clause to look at:
-        while (!seen[var(trail[index--])]);
-        p     = trail[index+1];
+        // Select next clause to look at (skipping lower-level literals placed out of order):
+        do{
+            while (!seen[var(trail[index--])]);
+            p = trail[index+1];
+        }while (level(var(p)) < confl_level);
         confl = reason(var(p));
         seen[var(p)] = 0;
         pathC--;
@@ -398,6 +857,13 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     }while (pathC > 0);
     out_learnt[0] = ~p;
 
+    // Move the variables met to the end of the VMTF queue, keeping their order:
+    if (queue_bumped.size() > 0){
+        sort(queue_bumped, QueueStampLt(queue_stamp));
+        for (int i = 0; i < queue_bumped.size(); i++)
+            queueBump(queue_bumped[i]);
+        queue_bumped.clear(); }
+
     // Simplify conflict clause:
     //
     int i, j;
@@ -418,7 +884,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
             if (reason(x) == CRef_Undef)
                 out_learnt[j++] = out_learnt[i];
             else{
-                Clause& c = ca[reason(var(out_learnt[i]))];
+                Clause& c = reasonClause(x);
                 for (int k = 1; k < c.size(); k++)
                     if (!seen[var(c[k])] && level(var(c[k])) > 0){
                         out_learnt[j++] = out_learnt[i];
@@ -430,6 +896,8 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 
     max_literals += out_learnt.size();
     out_learnt.shrink(i - j);
+    if (bin_min_lbd > 0 && out_learnt.size() > 2 && out_learnt.size() <= bin_min_size && lbd(out_learnt) <= bin_min_lbd)
+        binaryMinimize(out_learnt);
     tot_literals += out_learnt.size();
 
     // Find correct backtrack level:
@@ -468,6 +936,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     }
 #endif
     for (int j = 0; j < analyze_toclear.size(); j++) seen[var(analyze_toclear[j])] = 0;    // ('seen[]' is now cleared)
+    TIMER_STOP(T_ANALYZE);
 }
 
 
@@ -479,7 +948,7 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
     int top = analyze_toclear.size();
     while (analyze_stack.size() > 0){
         assert(reason(var(analyze_stack.last())) != CRef_Undef);
-        Clause& c = ca[reason(var(analyze_stack.last()))]; analyze_stack.pop();
+        Clause& c = reasonClause(var(analyze_stack.last())); analyze_stack.pop();
 
         for (int i = 1; i < c.size(); i++){
             Lit p  = c[i];
@@ -502,6 +971,35 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
 }
 
 
+// Removes the literals 'q' of 'out_learnt' for which a binary clause '(out_learnt[0] | ~q)' exists:
+// resolving on 'q' with it drops 'q'. Uses 'seen[]', which must be set for the variables of
+// 'out_learnt[1..]' (and is left non-zero for them).
+void Solver::binaryMinimize(vec<Lit>& out_learnt)
+{
+    // The variables of 'out_learnt[1..]' are marked 2, and the removable ones 3:
+    for (int i = 1; i < out_learnt.size(); i++)
+        seen[var(out_learnt[i])] = 2;
+
+    const vec<Watcher>& ws = watches_bin[~out_learnt[0]];
+    int removed = 0;
+    for (int k = 0; k < ws.size(); k++){
+        Lit imp = ws[k].blocker;
+        if (seen[var(imp)] == 2 && value(imp) == l_True){
+            seen[var(imp)] = 3;
+            removed++; }
+    }
+
+    if (removed > 0){
+        int i, j;
+        for (i = j = 1; i < out_learnt.size(); i++)
+            if (seen[var(out_learnt[i])] != 3)
+                out_learnt[j++] = out_learnt[i];
+        out_learnt.shrink(i - j);
+        bin_min_lits += removed;
+    }
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  analyzeFinal : (p : Lit)  ->  [void]
@@ -528,7 +1026,7 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
                 assert(level(x) > 0);
                 out_conflict.push(~trail[i]);
             }else{
-                Clause& c = ca[reason(x)];
+                Clause& c = reasonClause(x);
                 for (int j = 1; j < c.size(); j++)
                     if (level(var(c[j])) > 0)
                         seen[var(c[j])] = 1;
@@ -541,30 +1039,113 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
 }
 
 
-void Solver::uncheckedEnqueue(Lit p, CRef from)
+/*_________________________________________________________________________________________________
+|
+|  findConflictLevel : (confl : CRef) (single : bool&)  ->  [int]
+|  
+|  Description:
+|    Returns the highest decision level among the literals of the conflicting clause 'confl', and
+|    moves a literal of that level to the first position (keeping the watches consistent). 'single'
+|    tells whether it is the only literal of that level, in which case the clause is not a conflict
+|    but an implication missed at the level below.
+|________________________________________________________________________________________________@*/
+int Solver::findConflictLevel(CRef confl, bool& single)
+{
+    Clause& c         = ca[confl];
+    int     max_level = level(var(c[0]));
+    single = false;
+    if (max_level == decisionLevel() && level(var(c[1])) == decisionLevel())
+        return max_level;
+
+    int max_i = 0;
+    single = true;
+    for (int i = 1; i < c.size(); i++){
+        int l = level(var(c[i]));
+        if (l > max_level){
+            max_level = l; max_i = i; single = true;
+        }else if (l == max_level)
+            single = false;
+    }
+
+    if (max_i != 0){
+        Lit tmp = c[0]; c[0] = c[max_i]; c[max_i] = tmp;
+        if (max_i > 1){
+            // 'c[max_i]' (the old first literal) is no longer watched:
+            remove(watches[~c[max_i]], Watcher(confl, c[1]));
+            watches[~c[0]].push(Watcher(confl, c[1])); }
+    }
+    return max_level;
+}
+
+
+void Solver::uncheckedEnqueue(Lit p, CRef from) { uncheckedEnqueue(p, decisionLevel(), from); }
+
+void Solver::uncheckedEnqueue(Lit p, int level, CRef from)
 {
     assert(value(p) == l_Undef);
     picked[var(p)] = conflicts;
 #if ANTI_EXPLORATION
     uint64_t age = conflicts - canceled[var(p)];
-    if (age > 0) {
+    if (age > 0 && !stable && !vmtf) {
         double decay = pow(0.95, age);
         activity[var(p)] *= decay;
         if (order_heap.inHeap(var(p))) {
-            order_heap.increase(var(p));
+            order_heap.update(var(p), activity[var(p)]);
         }
     }
 #endif
     conflicted[var(p)] = 0;
 #if ALMOST_CONFLICT
     almost_conflicted[var(p)] = 0;
+#endif
+#if CLAUSE_TRACKING || SHARED_CLAUSE_USE_PER
+    if (from != CRef_Undef) markSharedUsed(ca[from]);
 #endif
     assigns[var(p)] = lbool(!sign(p));
-    vardata[var(p)] = mkVarData(from, decisionLevel());
+#if VECTOR_WATCH_SCAN
+    false_lits[toInt(~p) >> 5] |= 1u << (toInt(~p) & 31);
+#endif
+    vardata[var(p)] = mkVarData(from, level);
     trail.push_(p);
 }
 
 
+#if VECTOR_WATCH_SCAN && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AVX2_WATCH_SCAN
+#include <immintrin.h>
+
+static const bool cpu_avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+
+// Tests 8 literals at a time: gathers the words of 'false_lits' holding their bits, and shifts
+// each bit to the sign of its lane.
+__attribute__((target("avx2")))
+static int findWatchAVX2(const uint32_t* false_lits, const Lit* lits, int from, int to)
+{
+    int k = from;
+    for (; k + 8 <= to; k += 8){
+        __m256i x     = _mm256_loadu_si256((const __m256i*)(lits + k));
+        __m256i words = _mm256_i32gather_epi32((const int*)false_lits, _mm256_srli_epi32(x, 5), 4);
+        __m256i bits  = _mm256_sllv_epi32(words, _mm256_andnot_si256(x, _mm256_set1_epi32(31)));
+        int     mask  = _mm256_movemask_ps(_mm256_castsi256_ps(bits));
+        if (mask != 0xFF)
+            return k + __builtin_ctz(~mask); }
+    for (; k < to && (false_lits[toInt(lits[k]) >> 5] >> (toInt(lits[k]) & 31) & 1); k++);
+    return k;
+}
+#endif
+
+inline int Solver::findWatch(const Clause& c, int from, int to) const
+{
+#ifdef AVX2_WATCH_SCAN
+    if (cpu_avx2)
+        return findWatchAVX2(&false_lits[0], (const Lit*)c, from, to);
+#endif
+    int k;
+    for (k = from; k < to && value(c[k]) == l_False; k++);
+    return k;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  propagate : [void]  ->  [Clause*]
@@ -578,30 +1159,36 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
 |________________________________________________________________________________________________@*/
 CRef Solver::propagate()
 {
+    TIMER_START(T_PROPAGATE);
     CRef    confl     = CRef_Undef;
     int     num_props = 0;
     watches.cleanAll();
+    watches_bin.cleanAll();
 
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
+        int            p_level = level(var(p));  // (below 'decisionLevel()' after a chronological backtrack)
         vec<Watcher>&  ws  = watches[p];
         Watcher        *i, *j, *end;
         num_props++;
 
-        for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
-
+        // Binary clauses first; the watcher holds the other literal, so the clause is not inspected:
+        vec<Watcher>&  ws_bin = watches_bin[p];
+        for (int k = 0; k < ws_bin.size(); k++){
+            Lit the_other = ws_bin[k].blocker;
+            if (value(the_other) == l_False){
+                confl = ws_bin[k].cref;
+                qhead = trail.size();
+                goto ExitProp;
+            }else if (value(the_other) == l_Undef)
+                uncheckedEnqueue(the_other, p_level, ws_bin[k].cref);
+        }
 
-            /**
-            * Modified by @lavleshm
-            * Added functionality to record shared clauses activity
-            */
-#if CLAUSE_TRACKING || SHARED_CLAUSE_USE_PER
-            //recording if a shared clause has been used added by @lavleshm
-            if(ca[i->cref].learnt() && ca[i->cref].shared() == 1){
-                ca[i->cref].update_shared(2);
-//                saveToFile(i->cref, sc_file);
-                nSharedsUSed++;
-            }
+        for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+#if PREFETCH_DISTANCE > 0 && defined(__GNUC__)
+            // Start loading a clause further down the list, unless its blocker will skip it:
+            if (end - i > PREFETCH_DISTANCE && value(i[PREFETCH_DISTANCE].blocker) != l_True)
+                __builtin_prefetch(ca.lea(i[PREFETCH_DISTANCE].cref));
 #endif
             // Try to avoid inspecting the clause:
             Lit blocker = i->blocker;
@@ -623,12 +1210,21 @@ CRef Solver::propagate()
             if (first != blocker && value(first) == l_True){
                 *j++ = w; continue; }
 
-            // Look for new watch:
-            for (int k = 2; k < c.size(); k++)
-                if (value(c[k]) != l_False){
-                    c[1] = c[k]; c[k] = false_lit;
-                    watches[~c[1]].push(w);
-                    goto NextClause; }
+            // Look for new watch (in long clauses, from where the last search stopped, wrapping around):
+            int k, sz = c.size();
+            if (c.has_pos()){
+                int pos = c.scanPos() < (uint32_t)sz ? c.scanPos() : 2;
+                k = findWatch(c, pos, sz);
+                if (k == sz){
+                    k = findWatch(c, 2, pos);
+                    if (k == pos) k = sz; }
+                if (k < sz) c.scanPos() = k;
+            }else
+                for (k = 2; k < sz && value(c[k]) == l_False; k++);
+            if (k < sz){
+                c[1] = c[k]; c[k] = false_lit;
+                watches[~c[1]].push(w);
+                goto NextClause; }
 
             // Did not find watch -- clause is unit under assignment:
             *j++ = w;
@@ -638,16 +1234,31 @@ CRef Solver::propagate()
                 // Copy the remaining watches:
                 while (i < end)
                     *j++ = *i++;
-            }else
-                uncheckedEnqueue(first, cr);
+            }else if (p_level == decisionLevel())
+                uncheckedEnqueue(first, p_level, cr);
+            else{
+                // Imply 'first' at the highest level of the other literals, and watch the literal of
+                // that level so that the clause is revisited when it is unassigned:
+                int max_k = 1, max_level = p_level;
+                for (int k = 2; k < c.size(); k++)
+                    if (level(var(c[k])) > max_level){
+                        max_level = level(var(c[k])); max_k = k; }
+                if (max_k != 1){
+                    c[1] = c[max_k]; c[max_k] = false_lit;
+                    j--;
+                    watches[~c[1]].push(w); }
+                uncheckedEnqueue(first, max_level, cr);
+            }
 
         NextClause:;
         }
         ws.shrink(i - j);
     }
+ExitProp:;
     propagations += num_props;
     simpDB_props -= num_props;
 
+    TIMER_STOP(T_PROPAGATE);
     return confl;
 }
 
@@ -662,51 +1273,174 @@ int min(int a, int b) {
 |  Description:
 |    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
 |    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+|
+|    With TIERED_CLAUSE_DB only the local tier is halved, by activity. Core clauses are never
+|    removed, and mid-tier clauses unused for 'tier2_keep' conflicts first move to the local tier.
+|
+|    The candidates are copied with their key into 'reduce_keys', and the half to delete is found
+|    by selection rather than by sorting, so the arena is only visited once per clause.
 |________________________________________________________________________________________________@*/
-struct reduceDB_lt { 
-    ClauseAllocator& ca;
-#if LBD_BASED_CLAUSE_DELETION
-    vec<double>& activity;
-    reduceDB_lt(ClauseAllocator& ca_,vec<double>& activity_) : ca(ca_), activity(activity_) {}
-#else
-    reduceDB_lt(ClauseAllocator& ca_) : ca(ca_) {}
-#endif
-    bool operator () (CRef x, CRef y) { 
-#if LBD_BASED_CLAUSE_DELETION
-        return ca[x].activity() > ca[y].activity();
-    }
-#else
-        return ca[x].size() > 2 && (ca[y].size() == 2 || ca[x].activity() < ca[y].activity()); } 
-#endif
-};
 void Solver::reduceDB()
 {
+    TIMER_START(T_REDUCEDB);
+    double  trace_start = trace.enabled() ? realTime() : 0;
+    int     learnts_before = learnts.size();
     int     i, j;
+
+    reduce_keys.clear();
+#if TIERED_CLAUSE_DB
+    for (i = j = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
+        if (c.tier() == TIER_MID && (uint32_t)conflicts - c.touched() > (uint32_t)tier2_keep){
+            c.tier(TIER_LOCAL);
+            c.activity() = 0;
+            claBumpActivity(c); }
+        if (c.tier() == TIER_LOCAL){
+            ReduceKey k = { -c.activity(), learnts[i] };
+            reduce_keys.push(k);
+        }else
+            learnts[j++] = learnts[i];
+    }
+    learnts.shrink(i - j);
+#else
+    for (i = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
 #if LBD_BASED_CLAUSE_DELETION
-    sort(learnts, reduceDB_lt(ca, activity));
+        ReduceKey k = { (float)c.activity(), learnts[i] };
 #else
-    double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
-    sort(learnts, reduceDB_lt(ca));
+        ReduceKey k = { c.size() == 2 ? (float)-HUGE_VAL : -c.activity(), learnts[i] };
+#endif
+        reduce_keys.push(k); }
+    learnts.clear();
+#endif
+#if ! LBD_BASED_CLAUSE_DELETION
+    double  extra_lim = cla_inc / reduce_keys.size();    // Remove any clause below this activity
 #endif
 
+    ReduceKey* keys = (ReduceKey*)reduce_keys;
+    int        cut  = reduce_keys.size() / 2;
+    std::nth_element(keys, keys + cut, keys + reduce_keys.size(), ReduceKey::Gt());
+
     // Don't delete binary or locked clauses. From the rest, delete clauses from the first half
-    // and clauses with activity smaller than 'extra_lim':
-#if LBD_BASED_CLAUSE_DELETION
-    for (i = j = 0; i < learnts.size(); i++){
-        Clause& c = ca[learnts[i]];
-        if (c.activity() > 2 && !locked(c) && i < learnts.size() / 2)
+    // and clauses with activity smaller than 'extra_lim' (tested on the keys where possible):
+    for (i = 0; i < reduce_keys.size(); i++){
+        const ReduceKey& k = keys[i];
+#if TIERED_CLAUSE_DB
+        if (i < cut && !locked(ca[k.cr]))
+#elif LBD_BASED_CLAUSE_DELETION
+        if (i < cut && k.key > 2 && !locked(ca[k.cr]))
 #else
-    for (i = j = 0; i < learnts.size(); i++){
-        Clause& c = ca[learnts[i]];
-        if (c.size() > 2 && !locked(c) && (i < learnts.size() / 2 || c.activity() < extra_lim))
+        if ((i < cut || -k.key < extra_lim) && k.key != (float)-HUGE_VAL && !locked(ca[k.cr]))
 #endif
-            removeClause(learnts[i]);
+            removeClause(k.cr);
         else
-            learnts[j++] = learnts[i];
+            learnts.push(k.cr);
     }
+    TIMER_STOP(T_REDUCEDB);
+    if (trace.enabled()) trace.complete(EventTrace::ReduceDB, trace_start, learnts_before, learnts.size());
+    checkGarbage();
+}
+
+
+#if TIERED_CLAUSE_DB
+/*_________________________________________________________________________________________________
+|
+|  vivifyLearnts : ()  ->  [bool]
+|  
+|  Description:
+|    Strengthens the core and mid-tier learnt clauses not vivified before, best LBD first, until
+|    the propagation budget is spent. The negations of the literals of a clause (detached
+|    meanwhile) are assigned one by one above level 0 and propagated. A literal that comes out false
+|    is dropped. Once a literal comes out true, or propagation fails, the literals kept so far
+|    form an implied clause, which replaces the clause. Returns FALSE if the formula is found UNSAT.
+|________________________________________________________________________________________________@*/
+struct vivify_lt {
+    ClauseAllocator& ca;
+    vivify_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) { return ca[x].lbd() < ca[y].lbd(); } };
+
+bool Solver::vivifyLearnts()
+{
+    assert(decisionLevel() == 0);
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    vec<CRef> cands;
+    for (int i = 0; i < learnts.size(); i++){
+        const Clause& c = ca[learnts[i]];
+        if (c.tier() != TIER_LOCAL && !c.vivified() && c.size() > 2)
+            cands.push(learnts[i]); }
+    sort(cands, vivify_lt(ca));
+
+    uint64_t limit = propagations + (uint64_t)(vivify_eff * (propagations - vivify_props));
+    vec<Lit> keep;
+    for (int n = 0; n < cands.size() && propagations < limit; n++){
+        CRef    cr = cands[n];
+        Clause& c  = ca[cr];
+        if (satisfied(c)){
+            removeClause(cr);
+            continue; }
+        c.vivified(true);
+        detachClause(cr, true);
+
+        keep.clear();
+        for (int i = 0; i < c.size(); i++){
+            Lit p = c[i];
+            if (value(p) == l_False) continue;
+            keep.push(p);
+            if (value(p) == l_True) break;
+            newDecisionLevel();
+            uncheckedEnqueue(~p);
+            if (propagate() != CRef_Undef) break;
+        }
+
+        // Undo the assignments, leaving the branching heuristic and the saved phases alone:
+        for (int i = trail.size()-1; i >= trail_lim[0]; i--){
+            Var x = var(trail[i]);
+            assigns[x] = l_Undef;
+#if VECTOR_WATCH_SCAN
+            false_lits[x >> 4] &= ~(3u << ((x & 15) * 2));
+#endif
+#if ANTI_EXPLORATION
+            canceled[x] = conflicts;
+#endif
+            insertVarOrder(x); }
+        qhead = trail_lim[0];
+        trail.shrink(trail.size() - trail_lim[0]);
+        trail_lim.clear();
+
+        if (keep.size() == c.size()){
+            attachClause(cr);
+            continue; }
+        vivified_clauses++;
+        vivified_lits += c.size() - keep.size();
+        if (keep.size() == 1){
+            c.mark(1);
+            ca.free(cr);
+            uncheckedEnqueue(keep[0]);
+            if (propagate() != CRef_Undef)
+                return ok = false;
+        }else{
+            for (int i = 0; i < keep.size(); i++)
+                c[i] = keep[i];
+            c.shrink(c.size() - keep.size());
+            if (c.size() < c.lbd()){
+                c.lbd(c.size());
+                if (c.size() <= core_lbd) c.tier(TIER_CORE); }
+            attachClause(cr);
+        }
+    }
+
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++)
+        if (ca[learnts[i]].mark() != 1)
+            learnts[j++] = learnts[i];
     learnts.shrink(i - j);
+    vivify_props = propagations;
     checkGarbage();
+    return true;
 }
+#endif
 
 
 void Solver::removeSatisfied(vec<CRef>& cs)
@@ -729,7 +1463,7 @@ void Solver::rebuildOrderHeap()
     for (Var v = 0; v < nVars(); v++)
         if (decision[v] && value(v) == l_Undef)
             vs.push(v);
-    order_heap.build(vs);
+    order_heap.build(vs, activity);
 }
 
 
@@ -787,6 +1521,8 @@ lbool Solver::search(int nof_conflicts)
 
     for (;;){
         iterations++;
+        if (peer_stop && (iterations & 63) == 0)
+            pollStop();
         /* Here add MPI_Probe and after getting the shared_clause do:
         *
         * CRef cr = ca.alloc(shared_clause, true);
@@ -795,8 +1531,11 @@ lbool Solver::search(int nof_conflicts)
         * claBumpActivity(ca[cr]);
         *
         * */
+        TIMER_START(T_IMPORT);
+        uint64_t batch_received = clauses_received, batch_imported = clauses_imported;
+        double   batch_start    = trace.enabled() ? realTime() : 0;
         int flag = 1;//, p = 0;//, flag1 = 0;
-        do{
+        if (det_epoch == 0) do{     // (in deterministic mode clauses are only imported by 'exchangeEpoch()')
              flag = 0;//, flag1 = 0;
             for(int rank = 0; rank < Comm_size; rank++) {
 
@@ -806,7 +1545,7 @@ lbool Solver::search(int nof_conflicts)
               MPI_Status my_status;
 //              MPI_Message message;
 //            int flag;
-              MPI_Iprobe(/*MPI_ANY_SOURCE */ rank, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, &my_status);
+              MPI_Iprobe(/*MPI_ANY_SOURCE */ rank, TAG_CLAUSE, MPI_COMM_WORLD, &flag, &my_status);
 //            MPI_Improbe(MPI_ANY_SOURCE /*rank*/, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, &message, &my_status);
 
             if (flag) {
@@ -820,6 +1559,7 @@ lbool Solver::search(int nof_conflicts)
                   int recv_buffer[recv_buffer_len];
                 MPI_Irecv(recv_buffer, recv_buffer_len, MPI_INT, my_status.MPI_SOURCE, my_status.MPI_TAG, MPI_COMM_WORLD, &recv_request);
                 MPI_Wait(&recv_request, &recv_status);
+                clauses_received++;
 //                  MPI_Recv(recv_buffer, recv_buffer_len, MPI_INT, my_status.MPI_SOURCE, my_status.MPI_TAG, MPI_COMM_WORLD, &recv_status);
 //                MPI_Mrecv(recv_buffer, recv_buffer_len, MPI_INT, &message, &recv_status);
 //                if (p > 1) continue;
@@ -893,7 +1633,11 @@ lbool Solver::search(int nof_conflicts)
                       cr = ca.alloc(shared_clause, true, 1);
                       learnts.push(cr);
                       attachClause(cr);
+#if TIERED_CLAUSE_DB
+                      initTier(ca[cr], lbds.size() + undef_count);
+#endif
                       ifAdded = true;
+                      clauses_imported++;
                       //claBumpActivity(ca[cr]);
                   }
 //                ifAdded = addSharedClause(shared_clause);
@@ -907,6 +1651,10 @@ lbool Solver::search(int nof_conflicts)
           }
       }
         }while(/*1.5*flag1>= Comm_size*/flag);
+        TIMER_STOP(T_IMPORT);
+        if (trace.enabled() && clauses_received > batch_received){
+            int received = clauses_received - batch_received, accepted = clauses_imported - batch_imported;
+            trace.complete(EventTrace::Import, batch_start, received, accepted, received - accepted); }
         //--------------------------------------------------------------------------------------------------------------
 
 
@@ -919,28 +1667,50 @@ lbool Solver::search(int nof_conflicts)
             Var v = var(trail[a]);
             uint64_t age = conflicts - last_conflict[v] + 1;
             double reward = multiplier / age ;
-            double old_activity = activity[v];
-            activity[v] = step_size * reward + ((1 - step_size) * old_activity);
-            if (order_heap.inHeap(v)) {
-                if (activity[v] > old_activity)
-                    order_heap.decrease(v);
-                else
-                    order_heap.increase(v);
-            }
+            activity[v] = step_size * reward + ((1 - step_size) * activity[v]);
+            if (order_heap.inHeap(v))
+                order_heap.set(v, activity[v]);
         }
+        order_heap.settle();
 #endif
         if (confl != CRef_Undef){
             // CONFLICT
             conflicts++; conflictC++;
 #if BRANCHING_HEURISTIC == CHB || BRANCHING_HEURISTIC == LRB
-            if (step_size > min_step_size)
+            if (!stable && step_size > min_step_size)
                 step_size -= step_size_dec;
 #endif
             if (decisionLevel() == 0) return l_False;
 
+            if (checkpoint_int > 0 && (conflicts & 1023) == 0 && realTime() >= next_checkpoint)
+                checkpoint_requested = true;
+
+            if (chrono >= 0){
+                // After chronological backtracking the conflict may be below the current level, or be
+                // a missed implication with a single literal at its highest level:
+                bool single;
+                int  confl_level = findConflictLevel(confl, single);
+                if (confl_level == 0) return l_False;
+                if (single){
+                    cancelUntil(confl_level - 1);
+                    continue; }
+            }
+
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
 
+            if (dyn_restarts && !stable){
+                // Postpone the next restart while the trail is much longer than usual, as the search
+                // may be close to a model ('conflictC' counts the conflicts the fast average has seen):
+                if (conflicts > (uint64_t)block_start && conflictC >= 50 && trail.size() > block_r * trail_avg.value){
+                    conflictC = 0;
+                    blocked_restarts++; }
+                trail_avg.update(trail.size());
+                int l = lbd(learnt_clause);
+                lbd_fast.update(l);
+                lbd_slow.update(l);
+            }
+
             /* Here add the sharing information for the learnt_clause recently discovered
              * Use of MPI_isend to all the other processes to send the learnt_clause(can not use MPI_Bcast as MPI_probe is
              * a point to point communication standard)
@@ -949,7 +1719,14 @@ lbool Solver::search(int nof_conflicts)
              *
              * */
             int buffer_len = learnt_clause.size();
-            if(buffer_len <= 8 && learnt_clause.size() > 1){
+            if(buffer_len <= 8 && learnt_clause.size() > 1 && det_epoch > 0 && Comm_size > 1){
+                // Deterministic mode: keep the clause for the next exchange.
+                epoch_sendbuf.push(buffer_len);
+                for (int i = 0; i < buffer_len; i++)
+                    epoch_sendbuf.push(toInt(learnt_clause[i]));
+                clauses_exported++;
+            }else if(buffer_len <= 8 && learnt_clause.size() > 1){
+                TIMER_START(T_EXPORT);
                 int send_buffer[buffer_len];
                 MPI_Request my_request[Comm_size-1];
 //                MPI_Status my_status[Comm_size-1];
@@ -969,41 +1746,53 @@ lbool Solver::search(int nof_conflicts)
                 //Send the buffer to all the other processes
 //                if(lbds.size()<5){
                     for(int i = 0 , j = 0; i < Comm_size ; i++){
-                        if(i != Mpi_rank) MPI_Isend(send_buffer, buffer_len, MPI_INT, i, i, MPI_COMM_WORLD, &my_request[j++]);
+                        if(i != Mpi_rank) MPI_Isend(send_buffer, buffer_len, MPI_INT, i, TAG_CLAUSE, MPI_COMM_WORLD, &my_request[j++]);
                     }
                     MPI_Waitall(Comm_size-1, my_request,MPI_STATUS_IGNORE);
+                    if (Comm_size > 1) clauses_exported++;
+                    if (Comm_size > 1 && trace.enabled()) trace.instant(EventTrace::Export, buffer_len);
 //                }
+                TIMER_STOP(T_EXPORT);
             }
 
             //------------------------------------------------------------------------------------------------------------
 
 
 
-            cancelUntil(backtrack_level);
+            if (chrono >= 0 && conflicts >= (uint64_t)confl_to_chrono && decisionLevel() - backtrack_level > chrono){
+                cancelUntil(level(var(ca[confl][0])) - 1);
+                chrono_backtracks++;
+            }else
+                cancelUntil(backtrack_level);
 
 #if BRANCHING_HEURISTIC == CHB
             action = trail.size();
 #endif
 
+            // The asserting literal belongs to 'backtrack_level', also when the trail is left higher:
             if (learnt_clause.size() == 1){
-                uncheckedEnqueue(learnt_clause[0]);
+                uncheckedEnqueue(learnt_clause[0], 0, CRef_Undef);
             }else{
                 CRef cr = ca.alloc(learnt_clause, true, 0);
                 learnts.push(cr);
                 attachClause(cr);
-#if LBD_BASED_CLAUSE_DELETION
+#if TIERED_CLAUSE_DB
+                initTier(ca[cr], lbd(ca[cr]));
+#elif LBD_BASED_CLAUSE_DELETION
                 Clause& clause = ca[cr];
                 clause.activity() = lbd(clause);
 #else
                 claBumpActivity(ca[cr]);
 #endif
-                uncheckedEnqueue(learnt_clause[0], cr);
+                uncheckedEnqueue(learnt_clause[0], backtrack_level, cr);
             }
 
 #if BRANCHING_HEURISTIC == VSIDS
             varDecayActivity();
+#elif STABLE_MODE
+            if (stable) varDecayActivity();
 #endif
-#if ! LBD_BASED_CLAUSE_DELETION
+#if CLAUSE_ACTIVITY
             claDecayActivity();
 #endif
 
@@ -1035,22 +1824,50 @@ lbool Solver::search(int nof_conflicts)
 #endif
             }
 
+            if (det_epoch > 0 && Comm_size > 1 && conflicts >= next_epoch){
+                next_epoch += det_epoch;
+                if (exchangeEpoch(0)){
+                    asynch_interrupt = true;
+                    return l_Undef; }
+                if (!ok) return l_False;
+#if BRANCHING_HEURISTIC == CHB
+                action = trail.size();
+#endif
+            }
+
         }else{
             // NO CONFLICT
-            if (nof_conflicts >= 0 && conflictC >= nof_conflicts || !withinBudget()){
+            if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || !withinBudget() || checkpoint_requested
+                || (dyn_restarts && !stable && conflictC >= 50 && lbd_fast.value * restart_k > lbd_slow.value)){
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(0);
+                if (reuse_trail){
+                    int level = reusedTrailLevel();
+                    reused_levels += level;
+                    cancelUntil(level);
+                }else
+                    cancelUntil(0);
                 //added by @lavleshm there might be previously shared clauses that might not have been propagated before
                 //restart but propagated after it, which makes the count go more than 100 percent
 //                nShareds = 0;
 //                nSharedsUSed = 0;
+                if (trace.enabled()) trace.instant(EventTrace::Restart, (int)conflicts);
                 return l_Undef; }
 
             // Simplify the set of problem clauses:
-            if (decisionLevel() == 0 && !simplify())
-                return l_False;
-
+            if (decisionLevel() == 0){
+                TIMER_START(T_SIMPLIFY);
+                bool simplified = simplify();
+                TIMER_STOP(T_SIMPLIFY);
+                if (!simplified)
+                    return l_False; }
+
+#if TIERED_CLAUSE_DB
+            if (conflicts >= next_reduce){
+                // Reduce the local tier of learnt clauses:
+                next_reduce = conflicts + reduce_int;
+                reduceDB(); }
+#else
             if (learnts.size()-nAssigns() >= max_learnts) {
                 // Reduce the set of learnt clauses:
                 reduceDB();
@@ -1058,6 +1875,7 @@ lbool Solver::search(int nof_conflicts)
                 max_learnts += 500;
 #endif
             }
+#endif
 
             Lit next = lit_Undef;
             while (decisionLevel() < assumptions.size()){
@@ -1096,6 +1914,18 @@ lbool Solver::search(int nof_conflicts)
 }
 
 
+const char* const Solver::timer_names[T_NTIMERS] = { "import", "export", "propagate", "analyze", "reducedb", "simplify", "gc" };
+
+// Converts the ticks of timer 't' into seconds, using the tick rate observed since construction.
+double Solver::timerSeconds(int t) const
+{
+    double elapsed = realTime() - timer_wall0;
+    uint64_t ticks = cpuTicks() - timer_ticks0;
+    if (elapsed <= 0 || ticks == 0) return 0;
+    return timer_ticks[t] / (ticks / elapsed);
+}
+
+
 double Solver::progressEstimate() const
 {
     double  progress = 0;
@@ -1147,20 +1977,43 @@ lbool Solver::solve_()
 
     solves++;
 
+    // A resumed search keeps the learnt clause limits stored in the checkpoint:
+    if (!resumed){
 #if RAPID_DELETION
-    max_learnts               = 2000;
+        max_learnts               = 2000;
 #else
-    max_learnts               = nClauses() * learntsize_factor;
+        max_learnts               = nClauses() * learntsize_factor;
 #endif
-    learntsize_adjust_confl   = learntsize_adjust_start_confl;
-    learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
+        learntsize_adjust_confl   = learntsize_adjust_start_confl;
+        learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
+    }
+#if TIERED_CLAUSE_DB
+    next_reduce               = conflicts + reduce_int;
+    next_vivify               = conflicts + vivify_int;
+    vivify_props              = propagations;
+#endif
+    resumed                   = false;
+    dyn_restarts              = restart_mode == 1 || (restart_mode == 2 && Mpi_rank % 2 == 1);
+    bool    was_vmtf          = vmtf;
+    vmtf                      = vmtf_mode == 1 || (vmtf_mode == 2 && Mpi_rank % 2 == 1);
+    if (vmtf)          queue_search = queue_last;   // ('insertVarOrder()' may have used the heap)
+    else if (was_vmtf) rebuildOrderHeap();
+    bool    walker            = walkers > 0 && det_epoch == 0 && assumptions.size() == 0 && Mpi_rank >= std::max(1, Comm_size - walkers);
+    next_checkpoint           = realTime() + checkpoint_int;
     lbool   status            = l_Undef;
 
     if (verbosity >= 1){
         printf("LBD Based Clause Deletion : %d\n", LBD_BASED_CLAUSE_DELETION);
-        printf("Rapid Deletion : %d\n", RAPID_DELETION);
+        printf("Rapid Deletion : %d\n", RAPID_DELETION && !TIERED_CLAUSE_DB);
+        printf("Tiered Clause Database : %d\n", TIERED_CLAUSE_DB);
         printf("Almost Conflict : %d\n", ALMOST_CONFLICT);
         printf("Anti Exploration : %d\n", ANTI_EXPLORATION);
+        printf("Dynamic Restarts : %d\n", dyn_restarts);
+        printf("VMTF Queue : %d\n", vmtf);
+        printf("Local Search : %d\n", walker);
+#if STABLE_MODE
+        printf("Mode Switching : %d\n", mode_int > 0);
+#endif
         printf("============================[ Search Statistics ]==============================\n");
         printf("| Conflicts |          ORIGINAL         |          LEARNT          | Progress |\n");
         printf("|           |    Vars  Clauses Literals |    Limit  Clauses Lit/Cl |          |\n");
@@ -1168,13 +2021,77 @@ lbool Solver::solve_()
     }
 
     // Search:
-    int curr_restarts = 0;
-    while (status == l_Undef){
+    int curr_restarts = 0, stable_restarts = 0;
+    if (next_rephase == 0)
+        next_rephase = conflicts + rephase_int;
+#if STABLE_MODE
+    if (mode_int == 0 && stable)
+        switchMode();
+    if (mode_len == 0){
+        mode_len    = mode_int;
+        next_switch = conflicts + mode_int; }
+#endif
+    next_phase_share  = conflicts + phase_share_int;
+    walker_imported   = UINT32_MAX;
+    next_epoch        = conflicts + det_epoch;
+    epoch_stopped     = false;
+    det_winner        = -1;
+    epoch_sendbuf.clear();
+    epoch_sendbuf.push(0);
+    if (walker)
+        status = localSearch();
+    while (status == l_Undef && !walker){
         double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
-        status = search(rest_base * restart_first);
+        int    nof_conflicts = dyn_restarts ? -1 : rest_base * restart_first;
+#if STABLE_MODE
+        if (stable)
+            nof_conflicts = luby(restart_inc, stable_restarts) * stable_restart;
+        // (modes end with a restart)
+        if (mode_int > 0 && (nof_conflicts < 0 || conflicts + nof_conflicts > next_switch))
+            nof_conflicts = next_switch > conflicts ? next_switch - conflicts : 1;
+#endif
+        status = search(nof_conflicts);
         if (!withinBudget()) break;
-        curr_restarts++;
+        if (stable) stable_restarts++;
+        else        curr_restarts++;
+
+#if STABLE_MODE
+        if (status == l_Undef && mode_int > 0 && conflicts >= next_switch){
+            cancelUntil(0);
+            switchMode(); }
+#endif
+
+        if (status == l_Undef && rephase_int > 0 && conflicts >= next_rephase){
+            cancelUntil(0);
+            if (!rephase()) status = l_False; }
+
+        // (a restart with 'reuse_trail' may have kept part of the trail)
+        if (status == l_Undef && phase_share_int > 0 && det_epoch == 0 && conflicts >= next_phase_share){
+            cancelUntil(0);
+            sharePhase();
+            next_phase_share = conflicts + phase_share_int; }
+
+#if TIERED_CLAUSE_DB
+        if (status == l_Undef && vivify_int > 0 && conflicts >= next_vivify){
+            cancelUntil(0);
+            if (!vivifyLearnts()) status = l_False;
+            next_vivify = conflicts + vivify_int; }
+#endif
+
+        if (status == l_Undef && checkpoint_requested){
+            cancelUntil(0);
+            if (checkpoint_file.size() > 0 && !writeCheckpoint(checkpoint_file.c_str()))
+                fprintf(stderr, "WARNING! Could not write checkpoint: %s\n", checkpoint_file.c_str());
+            checkpoint_requested = false;
+            next_checkpoint      = realTime() + checkpoint_int; }
     }
+    cancelPhaseSends();
+
+    // Leaving: the other ranks learn it in their next exchange and stop there.
+    if (det_epoch > 0 && Comm_size > 1 && !epoch_stopped)
+        exchangeEpoch(status == l_True ? 10 : status == l_False ? 20 : 1);
+
+    if (trace.enabled()) trace.instant(EventTrace::Terminate, status == l_True ? 10 : status == l_False ? 20 : 0, asynch_interrupt);
 
     if (verbosity >= 1)
         printf("===============================================================================\n");
@@ -1191,6 +2108,421 @@ lbool Solver::solve_()
     return status;
 }
 
+//=================================================================================================
+// Deterministic clause exchange:
+//
+// With 'det_epoch' set, learnt clauses are not sent as they are found but collected, and every
+// 'det_epoch' conflicts all ranks exchange them in one collective. Every rank then backtracks to
+// level 0 and imports the clauses of the other ranks in rank order, so the search of each rank
+// only depends on the input and the number of ranks. A rank leaving 'solve_()' makes one last
+// exchange carrying its exit code; all ranks stop after the exchange where they see one.
+
+bool Solver::exchangeEpoch(int exit_code)
+{
+    double start = realTime();
+    epoch_sendbuf[0] = exit_code;
+
+    int      len = epoch_sendbuf.size(), total = 0;
+    vec<int> lens(Comm_size), displs(Comm_size);
+    MPI_Allgather(&len, 1, MPI_INT, (int*)lens, 1, MPI_INT, MPI_COMM_WORLD);
+    for (int r = 0; r < Comm_size; r++){
+        displs[r] = total;
+        total    += lens[r]; }
+    vec<int> recv(total);
+    MPI_Allgatherv((int*)epoch_sendbuf, len, MPI_INT, (int*)recv, (int*)lens, (int*)displs, MPI_INT, MPI_COMM_WORLD);
+    det_sync_time += realTime() - start;
+    det_epochs++;
+    epoch_sendbuf.clear();
+    epoch_sendbuf.push(0);
+
+    for (int r = 0; r < Comm_size; r++)
+        if (recv[displs[r]] != 0){
+            det_winner    = r;
+            epoch_stopped = true;
+            return true; }
+
+    uint64_t received = clauses_received, imported = clauses_imported;
+    cancelUntil(0);
+    vec<Lit> ps;
+    for (int r = 0; r < Comm_size && ok; r++){
+        if (r == Mpi_rank) continue;
+        for (int i = displs[r] + 1; i < displs[r] + lens[r] && ok; i += recv[i] + 1){
+            ps.clear();
+            for (int j = 0; j < recv[i]; j++)
+                ps.push(toLit(recv[i + 1 + j]));
+            clauses_received++;
+            importClause(ps);
+        }
+    }
+    if (trace.enabled() && clauses_received > received){
+        int n_received = clauses_received - received, n_imported = clauses_imported - imported;
+        trace.complete(EventTrace::Import, start, n_received, n_imported, n_received - n_imported); }
+    return false;
+}
+
+
+// Adds the shared clause 'ps' at decision level 0 (modifies 'ps'). Sets 'ok' to false if it is
+// falsified by the level 0 assignment.
+void Solver::importClause(vec<Lit>& ps)
+{
+    assert(decisionLevel() == 0);
+    int i, j;
+    for (i = j = 0; i < ps.size(); i++)
+        if (value(ps[i]) == l_True)
+            return;
+        else if (value(ps[i]) == l_Undef)
+            ps[j++] = ps[i];
+    ps.shrink(i - j);
+
+    clauses_imported++;
+    if (ps.size() == 0)
+        ok = false;
+    else if (ps.size() == 1)
+        uncheckedEnqueue(ps[0]);
+    else{
+        CRef cr = ca.alloc(ps, true, 1);
+        learnts.push(cr);
+        attachClause(cr);
+#if TIERED_CLAUSE_DB
+        initTier(ca[cr], ps.size());    // (the LBD is unknown at level 0; the size bounds it)
+#endif
+#if CLAUSE_TRACKING || SHARED_CLAUSE_USE_PER
+        nShareds++;
+#endif
+    }
+}
+
+
+//=================================================================================================
+// Best-phase sharing between ranks:
+//
+// A phase message is a vector of 'uint32_t': the length of the trail it was taken from (0 for a
+// phase of a local search rank), the number of variables, the number of clauses the phase falsifies
+// (UINT32_MAX for a trail phase), and then one polarity bit per variable (bit 'v % 32' of word
+// '3 + v / 32'). Trail phases are compared by their trail length and local search phases by their
+// falsified clauses. A CDCL rank prefers a longer trail, and otherwise takes a local search phase
+// better than any it took before; a local search rank only takes those of the other local search ranks.
+
+
+void Solver::sharePhase(int falsified)
+{
+    assert(decisionLevel() == 0);
+    if (Comm_size <= 1) return;
+
+    // Publish our own best phase, unless the previous one is still in flight:
+    int flag = 1;
+    if (phase_requests.size() > 0)
+        MPI_Testall(phase_requests.size(), (MPI_Request*)phase_requests, &flag, MPI_STATUSES_IGNORE);
+    if (flag && (best_trail > 0 || best_falsified >= 0)){
+        int words = (nVars() + 31) / 32;
+        phase_sendbuf.clear();
+        phase_sendbuf.growTo(3 + words, 0);
+        phase_sendbuf[0] = best_trail;
+        phase_sendbuf[1] = nVars();
+        phase_sendbuf[2] = best_falsified >= 0 ? (uint32_t)best_falsified : UINT32_MAX;
+        for (Var v = 0; v < nVars(); v++)
+            if (best_polarity[v])
+                phase_sendbuf[3 + v / 32] |= 1u << (v % 32);
+
+        phase_requests.clear();
+        for (int i = 0; i < Comm_size; i++)
+            if (i != Mpi_rank){
+                phase_requests.push();
+                MPI_Isend((uint32_t*)phase_sendbuf, phase_sendbuf.size(), MPI_UINT32_T, i, TAG_PHASE, MPI_COMM_WORLD, &phase_requests.last()); }
+        phase_exports++;
+    }
+
+    // Drain all pending phases and keep the one taken from the longest trail, and the local search
+    // phase with the fewest falsified clauses:
+    vec<uint32_t> recv, best, best_walk;
+    for (;;){
+        MPI_Status status;
+        MPI_Iprobe(MPI_ANY_SOURCE, TAG_PHASE, MPI_COMM_WORLD, &flag, &status);
+        if (!flag) break;
+
+        int len;
+        MPI_Get_count(&status, MPI_UINT32_T, &len);
+        recv.clear();
+        recv.growTo(len);
+        MPI_Recv((uint32_t*)recv, len, MPI_UINT32_T, status.MPI_SOURCE, TAG_PHASE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        if (len < 3 || (int)recv[1] != nVars())
+            continue;
+        if (recv[2] == UINT32_MAX){
+            if (best.size() == 0 || recv[0] > best[0]) recv.copyTo(best);
+        }else if (best_walk.size() == 0 || recv[2] < best_walk[2])
+            recv.copyTo(best_walk);
+    }
+
+    // A longer trail first, then a local search phase better than our own or than the last taken:
+    const vec<uint32_t>* import = NULL;
+    if (falsified < 0 && best.size() > 0 && (int)best[0] > best_trail)
+        import = &best;
+    else if (best_walk.size() > 0 && best_walk[2] < (falsified >= 0 ? (uint32_t)falsified : walker_imported))
+        import = &best_walk;
+
+    if (phase_import && import != NULL){
+        for (Var v = 0; v < nVars(); v++)
+            if (value(v) == l_Undef)
+                polarity[v] = ((*import)[3 + v / 32] >> (v % 32)) & 1;
+        if (import == &best_walk && falsified < 0)
+            walker_imported = best_walk[2];
+        phase_imports++;
+    }
+
+    if (trace.enabled()) trace.instant(EventTrace::PhaseShare, best_trail, best.size() > 0 ? best[0] : 0);
+    best_trail     = 0;
+    best_falsified = -1;
+}
+
+
+void Solver::cancelPhaseSends()
+{
+    for (int i = 0; i < phase_requests.size(); i++){
+        int flag;
+        MPI_Test(&phase_requests[i], &flag, MPI_STATUS_IGNORE);
+        if (!flag){
+            MPI_Cancel(&phase_requests[i]);
+            MPI_Request_free(&phase_requests[i]); }
+    }
+    phase_requests.clear();
+}
+
+
+//=================================================================================================
+// Stopping the other ranks:
+//
+// When 'peer_stop' is set, the first rank that finishes a query announces it and the others
+// interrupt their search. The driver must then call 'waitStops()' on every rank with the number of
+// other ranks that finished, so that no stop message is left over for the next query.
+
+
+void Solver::announceStop()
+{
+    stop_requests.clear();
+    for (int i = 0; i < Comm_size; i++)
+        if (i != Mpi_rank){
+            stop_requests.push();
+            MPI_Isend(&stop_sendbuf, 1, MPI_INT, i, TAG_STOP, MPI_COMM_WORLD, &stop_requests.last()); }
+}
+
+
+void Solver::pollStop()
+{
+    int flag;
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, TAG_STOP, MPI_COMM_WORLD, &flag, &status);
+    while (flag){
+        int dummy;
+        MPI_Recv(&dummy, 1, MPI_INT, status.MPI_SOURCE, TAG_STOP, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        stops_received++;
+        asynch_interrupt = true;
+        MPI_Iprobe(MPI_ANY_SOURCE, TAG_STOP, MPI_COMM_WORLD, &flag, &status);
+    }
+}
+
+
+void Solver::waitStops(int n)
+{
+    for (; stops_received < n; stops_received++){
+        int dummy;
+        MPI_Recv(&dummy, 1, MPI_INT, MPI_ANY_SOURCE, TAG_STOP, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+    if (stop_requests.size() > 0)
+        MPI_Waitall(stop_requests.size(), (MPI_Request*)stop_requests, MPI_STATUSES_IGNORE);
+    stop_requests.clear();
+    stops_received = 0;
+}
+
+
+//=================================================================================================
+// Checkpointing:
+//
+// The checkpoint is a binary dump in native byte order: a header, the statistics and search
+// parameters that evolve during search, the per-variable heuristic state, the top-level trail and
+// finally the clause arena itself (compacted by a garbage collection first) together with the
+// references of the original and learnt clauses. Nothing is formatted per clause, so writing and
+// reading are bounded by the I/O bandwidth.
+
+static const uint32_t checkpoint_magic   = 0x4b43534d; // "MSCK"
+static const uint32_t checkpoint_version = 4; // (2: clause headers with a saved scan position, 3: learnt clause tiers, 4: search modes)
+
+
+bool Solver::writeCheckpoint(const char* file)
+{
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+
+    // Write to a temporary file first, so that a crash while writing never destroys the last
+    // complete checkpoint:
+    std::string tmp = std::string(file) + ".tmp";
+    FILE* out = fopen(tmp.c_str(), "wb");
+    if (out == NULL) return false;
+
+    garbageCollect();
+    writeVal(out, checkpoint_magic);
+    writeVal(out, checkpoint_version);
+    writeState(out);
+
+    bool ok_write = !ferror(out);
+    ok_write &= fclose(out) == 0;
+    if (ok_write && rename(tmp.c_str(), file) == 0){
+        if (verbosity >= 1)
+            printf("|  Checkpoint written: %s\n", file);
+        return true; }
+
+    ::remove(tmp.c_str());
+    return false;
+}
+
+
+bool Solver::readCheckpoint(const char* file)
+{
+    assert(decisionLevel() == 0);
+    FILE* in = fopen(file, "rb");
+    if (in == NULL) return false;
+
+    uint32_t magic, version;
+    bool ok_read = readVal(in, magic) && magic == checkpoint_magic
+                && readVal(in, version) && version == checkpoint_version
+                && readState(in);
+    fclose(in);
+    return ok_read;
+}
+
+
+void Solver::writeState(FILE* out)
+{
+    writeVal(out, nVars());
+
+    // Statistics and evolving parameters:
+    writeVal(out, solves); writeVal(out, starts); writeVal(out, decisions); writeVal(out, rnd_decisions);
+    writeVal(out, propagations); writeVal(out, conflicts); writeVal(out, max_literals); writeVal(out, tot_literals);
+    writeVal(out, iterations); writeVal(out, random_seed);
+    writeVal(out, max_learnts); writeVal(out, learntsize_adjust_confl); writeVal(out, learntsize_adjust_cnt);
+    writeVal(out, var_inc);
+#if BRANCHING_HEURISTIC == CHB || BRANCHING_HEURISTIC == LRB
+    writeVal(out, step_size);
+#endif
+#if CLAUSE_ACTIVITY
+    writeVal(out, cla_inc);
+#endif
+
+#if STABLE_MODE
+    writeVal(out, stable); writeVal(out, next_switch); writeVal(out, mode_len);
+#endif
+
+    // Variables and top-level assignments:
+    writeVec(out, activity);
+#if STABLE_MODE
+    writeVec(out, other_activity);
+#endif
+    writeVec(out, polarity);
+    writeVec(out, decision);
+    writeVec(out, trail);
+
+    // Clause arena:
+    uint32_t words = ca.size();
+    writeVal(out, ca.extra_clause_field);
+    writeVal(out, words);
+    if (words > 0)
+        fwrite(ca.lea(0), sizeof(uint32_t), words, out);
+    writeVec(out, clauses);
+    writeVec(out, learnts);
+}
+
+
+bool Solver::readState(FILE* in)
+{
+    int n;
+    if (!readVal(in, n) || n != nVars()) return false;
+
+    readVal(in, solves); readVal(in, starts); readVal(in, decisions); readVal(in, rnd_decisions);
+    readVal(in, propagations); readVal(in, conflicts); readVal(in, max_literals); readVal(in, tot_literals);
+    readVal(in, iterations); readVal(in, random_seed);
+    readVal(in, max_learnts); readVal(in, learntsize_adjust_confl); readVal(in, learntsize_adjust_cnt);
+    readVal(in, var_inc);
+#if BRANCHING_HEURISTIC == CHB || BRANCHING_HEURISTIC == LRB
+    readVal(in, step_size);
+#endif
+#if CLAUSE_ACTIVITY
+    readVal(in, cla_inc);
+#endif
+#if STABLE_MODE
+    readVal(in, stable); readVal(in, next_switch); readVal(in, mode_len);
+#endif
+
+    vec<double> act;
+    vec<char>   pol, dec;
+    vec<Lit>    units;
+    vec<CRef>   cls, lrn;
+    bool        extra;
+    uint32_t    words;
+    if (!readVec(in, act) || act.size() != n)
+        return false;
+#if STABLE_MODE
+    if (!readVec(in, other_activity) || other_activity.size() != n)
+        return false;
+    target_trail = 0;
+#endif
+    if (!readVec(in, pol) || !readVec(in, dec) || !readVec(in, units)
+        || pol.size() != n || dec.size() != n
+        || !readVal(in, extra) || !readVal(in, words))
+        return false;
+
+    ClauseAllocator to(words > 0 ? words : 1);
+    to.extra_clause_field = extra;
+    if (words > 0 && fread(to.lea(to.RegionAllocator<uint32_t>::alloc(words)), sizeof(uint32_t), words, in) != words)
+        return false;
+    if (!readVec(in, cls) || !readVec(in, lrn))
+        return false;
+
+    // Replace the clause database:
+    for (int i = 0; i < trail.size(); i++){
+        assigns[var(trail[i])] = l_Undef;
+        vardata[var(trail[i])] = mkVarData(CRef_Undef, 0); }
+#if VECTOR_WATCH_SCAN
+    for (int i = 0; i < false_lits.size(); i++)
+        false_lits[i] = 0;
+#endif
+    trail.clear();
+    trail_lim.clear();
+    for (Var v = 0; v < nVars(); v++){
+        watches[mkLit(v, false)].clear();
+        watches[mkLit(v, true )].clear();
+        watches_bin[mkLit(v, false)].clear();
+        watches_bin[mkLit(v, true )].clear(); }
+    clauses_literals = learnts_literals = 0;
+
+    to.moveTo(ca);
+    cls.moveTo(clauses);
+    lrn.moveTo(learnts);
+    for (int i = 0; i < clauses.size(); i++) attachClause(clauses[i]);
+    for (int i = 0; i < learnts.size(); i++) attachClause(learnts[i]);
+
+    // Variables:
+    for (Var v = 0; v < nVars(); v++){
+        activity[v] = act[v];
+        polarity[v] = pol[v];
+        setDecisionVar(v, dec[v]);
+        picked[v]   = conflicts;
+#if ANTI_EXPLORATION
+        canceled[v] = conflicts;
+#endif
+    }
+    for (int i = 0; i < units.size(); i++)
+        if (value(units[i]) == l_Undef)
+            uncheckedEnqueue(units[i]);
+
+    qhead          = 0;
+    simpDB_assigns = -1;
+    simpDB_props   = 0;
+    resumed        = true;
+    rebuildOrderHeap();
+    ok = propagate() == CRef_Undef;
+    return true;
+}
+
+
 //=================================================================================================
 // Writing CNF to DIMACS:
 // 
@@ -1278,6 +2610,7 @@ void Solver::relocAll(ClauseAllocator& to)
     //
     // for (int i = 0; i < watches.size(); i++)
     watches.cleanAll();
+    watches_bin.cleanAll();
     for (int v = 0; v < nVars(); v++)
         for (int s = 0; s < 2; s++){
             Lit p = mkLit(v, s);
@@ -1285,6 +2618,9 @@ void Solver::relocAll(ClauseAllocator& to)
             vec<Watcher>& ws = watches[p];
             for (int j = 0; j < ws.size(); j++)
                 ca.reloc(ws[j].cref, to);
+            vec<Watcher>& ws_bin = watches_bin[p];
+            for (int j = 0; j < ws_bin.size(); j++)
+                ca.reloc(ws_bin[j].cref, to);
         }
 
     // All reasons:
@@ -1362,6 +2698,9 @@ bool Solver::addSharedClause(vec<Lit> &ps)
         CRef cr = ca.alloc(ps, true, 1);
        learnts.push(cr);
         attachClause(cr);
+#if TIERED_CLAUSE_DB
+        initTier(ca[cr], ps.size());
+#endif
     }
     return true;
 }
@@ -21,16 +21,38 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Solver_h
 #define Minisat_Solver_h
 
+#include <stdio.h>
 #include <string>
+#include <mpi.h>
 #include "../mtl/Vec.h"
 #include "../mtl/Heap.h"
+#include "../mtl/DaryHeap.h"
 #include "../mtl/Alg.h"
 #include "../utils/Options.h"
+#include "../utils/System.h"
 #include "../core/SolverTypes.h"
+#include "../core/Trace.h"
 
 
 namespace Minisat {
 
+//=================================================================================================
+// MPI message tags used between the solver ranks:
+
+enum { TAG_CLAUSE = 0, TAG_PHASE = 1, TAG_STOP = 2, TAG_RESULT = 3, TAG_TRACE = 4 };
+
+//=================================================================================================
+// Timers for the phases of the search loop. They accumulate into 'timer_ticks[t]' and count
+// 'timer_calls[t]' of the enclosing solver, and compile to nothing unless SEARCH_TIMERS is set:
+
+#if SEARCH_TIMERS
+#define TIMER_START(t) uint64_t timer_start_##t = cpuTicks()
+#define TIMER_STOP(t)  (timer_ticks[t] += cpuTicks() - timer_start_##t, timer_calls[t]++)
+#else
+#define TIMER_START(t)
+#define TIMER_STOP(t)
+#endif
+
 //=================================================================================================
 // Solver -- the main class:
 
@@ -108,6 +130,17 @@ public:
     void    checkGarbage(double gf);
     void    checkGarbage();
 
+    // Checkpointing:
+    //
+    bool    writeCheckpoint  (const char* file); // Save the solver state to a binary file. Requires decision level 0.
+    bool    readCheckpoint   (const char* file); // Restore a state written by 'writeCheckpoint()' for the same (simplified) problem.
+    void    requestCheckpoint();                 // Write a checkpoint at the next restart (safe to call from a signal handler).
+
+    // Stopping the other ranks working on the same query (see 'peer_stop'):
+    //
+    void    announceStop     ();                 // Tell all other ranks that this rank has finished the current query.
+    void    waitStops        (int n);            // Consume the stops of the 'n' other ranks that finished and complete our own.
+
     // Extra results: (read-only member variable)
     //
     vec<lbool> model;             // If problem is satisfiable, this vector contains the model (if any).
@@ -122,16 +155,24 @@ public:
     double    step_size_dec;
     double    min_step_size;
 #endif
-#if BRANCHING_HEURISTIC == VSIDS
+#if BRANCHING_HEURISTIC == VSIDS || STABLE_MODE
     double    var_decay;
 #endif
-#if ! LBD_BASED_CLAUSE_DELETION
+#if CLAUSE_ACTIVITY
     double    clause_decay;
 #endif
     double    random_var_freq;
     double    random_seed;
     bool      luby_restart;
+    int       restart_mode;       // 0 = luby/geometric sequence, 1 = dynamic (LBD averages), 2 = dynamic on the odd ranks only.
+    double    restart_k;          // Dynamic restart when the fast LBD average times this exceeds the slow one.
+    double    block_r;            // Postpone a dynamic restart when the trail is this many times its average...
+    int       block_start;        // ...once this many conflicts are made.
+    bool      reuse_trail;        // Restart only down to the first decision less active than the next one (keeping the trail below).
+    int       vmtf_mode;          // 0 = decide on 'order_heap', 1 = on the VMTF queue in the focused mode, 2 = VMTF on the odd ranks only.
     int       ccmin_mode;         // Controls conflict clause minimization (0=none, 1=basic, 2=deep).
+    int       bin_min_lbd;        // Learnt clauses up to this LBD are also minimized with the binary clauses (0 = never)...
+    int       bin_min_size;       // ...provided they have at most this many literals.
     int       phase_saving;       // Controls the level of phase saving (0=none, 1=limited, 2=full).
     bool      rnd_pol;            // Use random polarities for branching heuristics.
     bool      rnd_init_act;       // Initialize variable activities with a small random value.
@@ -145,10 +186,47 @@ public:
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
 
+#if TIERED_CLAUSE_DB
+    int       core_lbd;           // Learnt clauses up to this LBD are kept for good (core tier).
+    int       tier2_lbd;          // Learnt clauses up to this LBD are kept while they are used (mid tier).
+    int       tier2_keep;         // Conflicts without use after which a mid-tier clause moves to the local tier.
+    int       reduce_int;         // Conflicts between two reductions of the local tier.
+    int       vivify_int;         // Conflicts between two vivifications of the core and mid-tier clauses (0 = never).
+    double    vivify_eff;         // Propagations a vivification may spend, relative to those of the search since the last one.
+#endif
+
+    std::string checkpoint_file;  // File written by requested and periodic checkpoints (empty = none).
+    int       checkpoint_int;     // Wall-clock seconds between periodic checkpoints (0 = only when requested).
+
+#if STABLE_MODE
+    int       mode_int;           // Conflicts of the first focused mode (0 = never leave it); later modes are longer...
+    double    mode_inc;           // ...by this factor for each focused/stable pair.
+    int       stable_restart;     // Unit of the luby restart sequence in the stable mode.
+#endif
+    int       rephase_int;        // Conflicts before the first rephasing, and increment of the interval after each (0 = never).
+    double    walk_eff;           // Clause visits of a rephasing walk, relative to the propagations of the search since the last one.
+
+    int       chrono;             // Backjumps over more than this many levels backtrack chronologically instead (-1 = never).
+    int       confl_to_chrono;    // Conflicts before chronological backtracking starts.
+
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t clauses_exported, clauses_received, clauses_imported; // Learnt clauses sent to / received from / kept from the other ranks.
+    uint64_t chrono_backtracks, reused_levels;
+    uint64_t bin_min_lits;     // Literals removed from learnt clauses by 'binaryMinimize()'.
+    uint64_t blocked_restarts, mode_switches;
+    uint64_t rephases, walk_flips;
+    uint64_t vivified_clauses, vivified_lits;  // Learnt clauses shortened or removed by vivification, and literals removed.
+
+    enum { T_IMPORT, T_EXPORT, T_PROPAGATE, T_ANALYZE, T_REDUCEDB, T_SIMPLIFY, T_GC, T_NTIMERS };
+    static const char* const timer_names[T_NTIMERS];
+    uint64_t timer_ticks[T_NTIMERS];  // Time spent per phase of the search loop (only with SEARCH_TIMERS).
+    uint64_t timer_calls[T_NTIMERS];
+    double   timerSeconds(int t) const;
+
+    EventTrace trace;         // Sharing, restart and clause database events (recorded once 'trace.init()' is called).
 
     uint64_t lbd_calls;
     vec<uint64_t> lbd_seen;
@@ -178,6 +256,18 @@ public:
     std::string sc_file;
     std::string sc_string;
     int nShareds, nSharedsUSed;
+
+    int       phase_share_int;    // Conflicts (flips on local search ranks) between two best-phase exchanges with the other ranks (0 = off).
+    bool      phase_import;       // Seed 'polarity' from a better peer phase at exchange points.
+    int       walkers;            // Number of ranks, the last ones but never rank 0, that run local search instead of CDCL.
+    uint64_t  phase_exports, phase_imports;
+
+    bool      peer_stop;          // Interrupt the search when another rank announces that it finished the query.
+
+    int       det_epoch;          // Conflicts between two synchronous clause exchanges (0 = asynchronous exchange).
+    uint64_t  det_epochs;         // Synchronous exchanges taken part in.
+    double    det_sync_time;      // Wall-clock time spent in the exchanges, including waiting for the slowest rank.
+    int       det_winner;         // Lowest rank that finished in the last exchange, or -1.
     /*----------------------------------------------------------------*/
 protected:
 
@@ -201,10 +291,8 @@ protected:
         bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
     };
 
-    struct VarOrderLt {
-        const vec<double>&  activity;
-        bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
-        VarOrderLt(const vec<double>&  act) : activity(act) { }
+    struct VarOrderLt {                     // (on the activities, which 'order_heap' keeps with the variables)
+        bool operator () (double x, double y) const { return x > y; }
     };
 
     // Solver state:
@@ -212,14 +300,19 @@ protected:
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
     vec<CRef>           clauses;          // List of problem clauses.
     vec<CRef>           learnts;          // List of learnt clauses.
-#if ! LBD_BASED_CLAUSE_DELETION
+#if CLAUSE_ACTIVITY
     double              cla_inc;          // Amount to bump next clause with.
 #endif
     vec<double>         activity;         // A heuristic measurement of the activity of a variable.
     double              var_inc;          // Amount to bump next variable with.
     OccLists<Lit, vec<Watcher>, WatcherDeleted>
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>
+                        watches_bin;      // As 'watches', for binary clauses; the blocker is the other literal.
     vec<lbool>          assigns;          // The current assignments.
+#if VECTOR_WATCH_SCAN
+    vec<uint32_t>       false_lits;       // Bit 'toInt(p)' is set iff literal 'p' is false (2 bits per variable).
+#endif
     vec<char>           polarity;         // The preferred polarity of each variable.
     vec<char>           decision;         // Declares if a variable is eligible for selection in the decision heuristic.
     vec<Lit>            trail;            // Assignment stack; stores all assigments made in the order they were made.
@@ -229,7 +322,8 @@ protected:
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
-    Heap<VarOrderLt>    order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+    DaryHeap<double, VarOrderLt, ORDER_HEAP_ARITY>
+                        order_heap;       // A priority queue of variables ordered with respect to the variable activity.
     double              progress_estimate;// Set by 'search()'.
     bool                remove_satisfied; // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
 
@@ -243,7 +337,27 @@ protected:
     vec<Lit>            analyze_toclear;
     vec<Lit>            add_tmp;
 
+    struct ReduceKey {                      // A learnt clause as deletion candidate of 'reduceDB()'.
+        float key;                          // (larger keys are deleted first)
+        CRef  cr;
+        struct Gt { bool operator()(const ReduceKey& x, const ReduceKey& y) const { return x.key > y.key; } }; };
+    vec<ReduceKey>      reduce_keys;
+
+    struct EMA {                            // Exponential moving average; the plain mean of the first 1/alpha values.
+        double   value, alpha;
+        uint64_t n;
+        EMA(double a) : value(0), alpha(a), n(0) {}
+        void update(double x) { n++; value += (1.0 / n > alpha ? 1.0 / n : alpha) * (x - value); } };
+    EMA                 lbd_fast, lbd_slow; // LBD of the learnt clauses, over the last 32 conflicts and over the last 16384.
+    EMA                 trail_avg;          // Trail size at conflicts, over the last 4096.
+    bool                dyn_restarts;       // The current 'solve_()' restarts on the LBD averages (see 'restart_mode').
+
     double              max_learnts;
+#if TIERED_CLAUSE_DB
+    uint64_t            next_reduce;        // Conflict count of the next 'reduceDB()'.
+    uint64_t            next_vivify;        // Conflict count of the next 'vivifyLearnts()'.
+    uint64_t            vivify_props;       // Propagation count at the end of the last 'vivifyLearnts()'.
+#endif
     double              learntsize_adjust_confl;
     int                 learntsize_adjust_cnt;
 
@@ -252,19 +366,90 @@ protected:
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
     bool                asynch_interrupt;
+    uint64_t            timer_ticks0;       // Tick counter and wall-clock time at construction, to convert ticks to seconds.
+    double              timer_wall0;
+
+    // Checkpointing:
+    //
+    bool                checkpoint_requested;
+    double              next_checkpoint;    // Wall-clock time of the next periodic checkpoint.
+    bool                resumed;            // Keep the restored learnt clause limits at the next 'solve_()'.
+
+    // Phases besides the saved ones in 'polarity':
+    //
+    vec<char>           best_polarity;    // Phase of the longest conflict-free trail seen since the last exchange or rephasing.
+    int                 best_trail;       // Size of that trail (0 = none recorded).
+    int                 best_falsified;   // On a local search rank, falsified clauses of 'best_polarity' instead (-1 = none to publish).
+    uint32_t            walker_imported;  // Fewest falsified clauses of a local search phase imported so far.
+    vec<char>           original_polarity;// Polarity given to 'newVar()'.
+    uint64_t            next_rephase;     // Conflict count of the next 'rephase()'.
+    uint64_t            walk_props;       // Propagation count at the end of the last 'walk()'.
+
+    // Search modes: the focused mode branches on LRB with the saved phases, the stable mode on VSIDS
+    // with the target phases. 'activity' and 'order_heap' always belong to the current mode.
+    //
+    bool                stable;           // In the stable mode (never without STABLE_MODE).
+#if STABLE_MODE
+    vec<double>         other_activity;   // Scores of the other mode: VSIDS while focused, LRB while stable.
+    vec<char>           target_polarity;  // Saved phases when the trail was the longest of the current stable mode.
+    int                 target_trail;     // Size of that trail.
+    uint64_t            next_switch;      // Conflict count of the next mode switch.
+    double              mode_len;         // Conflicts of the current mode.
+#endif
+
+    // VMTF decision queue: replaces the scores and 'order_heap' in the focused mode with 'vmtf'. The
+    // variables are linked in the order of their last bump, the most recently bumped last.
+    //
+    struct QueueLink { Var prev, next; };
+    struct QueueStampLt {
+        const vec<uint64_t>& stamp;
+        QueueStampLt(const vec<uint64_t>& s) : stamp(s) {}
+        bool operator()(Var x, Var y) const { return stamp[x] < stamp[y]; } };
+    bool                vmtf;             // The current 'solve_()' decides on the queue (see 'vmtf_mode').
+    vec<QueueLink>      queue_links;
+    vec<uint64_t>       queue_stamp;      // Time of the last bump of each variable (increasing along the queue).
+    Var                 queue_first, queue_last;
+    Var                 queue_search;     // No variable after it in the queue is unassigned.
+    uint64_t            queue_stamps;     // Last bump time given out.
+    vec<Var>            queue_bumped;     // The variables met by the current conflict analysis.
+
+    // Best-phase sharing between ranks:
+    //
+    uint64_t            next_phase_share; // Conflict count at which the next exchange happens.
+    vec<uint32_t>       phase_sendbuf;    // Bit-packed phase kept alive until the sends complete.
+    vec<MPI_Request>    phase_requests;
+
+    // Stopping on other ranks:
+    //
+    int                 stops_received;   // Stop messages consumed during the current query.
+    int                 stop_sendbuf;
+    vec<MPI_Request>    stop_requests;
+
+    // Deterministic exchange:
+    //
+    uint64_t            next_epoch;       // Conflict count at which the next exchange happens.
+    vec<int>            epoch_sendbuf;    // Exit code, then the exported clauses as (size, literals...).
+    bool                epoch_stopped;    // Another rank finished in an exchange; no further exchanges are made.
 
     // Main internal methods:
     //
     void     insertVarOrder   (Var x);                                                 // Insert a variable in the decision order priority queue.
+    void     queueBump        (Var x);                                                 // Move a variable to the end of the VMTF queue.
+    Var      nextQueued       ();                                                      // Last unassigned decision variable of the VMTF queue.
     Lit      pickBranchLit    ();                                                      // Return the next decision variable.
+    int      reusedTrailLevel ();                                                      // Level to restart to with 'reuse_trail'.
     void     newDecisionLevel ();                                                      // Begins a new decision level.
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
+    void     uncheckedEnqueue (Lit p, int level, CRef from);                           // Enqueue a literal at a given (possibly lower) decision level.
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
+    int      findWatch        (const Clause& c, int from, int to) const;               // First literal of 'c' in ['from', 'to') that is not false, or 'to'.
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
+    int      findConflictLevel(CRef confl, bool& single);                              // Highest level in a conflict clause, moved to its first literal.
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
+    void     binaryMinimize   (vec<Lit>& out_learnt);                                  // (helper method for 'analyze()')
 
     template<class V> int lbd (const V& clause) {
         lbd_calls++;
@@ -283,18 +468,37 @@ protected:
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
     void     rebuildOrderHeap ();
+    void     saveBestPhase    ();                                                      // Record the current trail as best phase if it is the longest one.
+#if STABLE_MODE
+    void     saveTargetPhase  ();                                                      // Record the saved phases and the current trail as target phase if it is the longest one.
+    void     switchMode       ();                                                      // Switch between the focused and the stable mode.
+#endif
+    bool     rephase          ();                                                      // Reset the saved phases to the next kind of the rephasing schedule.
+    int      walk             (uint64_t ticks);                                        // Local search from the saved phases; they become the best assignment found.
+    lbool    localSearch      ();                                                      // Main loop of a local search rank ('walkers').
+    void     sharePhase       (int falsified = -1);                                    // Publish the best phase and import a better one from the peers.
+    void     cancelPhaseSends ();                                                      // Drop best-phase sends that no peer has matched.
+    Clause&  reasonClause     (Var x);                                                 // The reason of 'x', with the implied literal first.
+    void     markSharedUsed   (Clause& c);                                             // Count an imported clause as used (once).
+    void     pollStop         ();                                                      // Interrupt the search if another rank has finished.
+    bool     exchangeEpoch    (int exit_code);                                         // Synchronous clause exchange; true if some rank finished.
+    void     importClause     (vec<Lit>& ps);                                          // Add a shared clause at decision level 0.
 
     // Maintaining Variable/Clause activity:
     //
-#if BRANCHING_HEURISTIC == VSIDS
+#if BRANCHING_HEURISTIC == VSIDS || STABLE_MODE
     void     varDecayActivity ();                      // Decay all variables with the specified factor. Implemented by increasing the 'bump' value instead.
     void     varBumpActivity  (Var v, double inc);     // Increase a variable with the current 'bump' value.
     void     varBumpActivity  (Var v);                 // Increase a variable with the current 'bump' value.
 #endif
-#if ! LBD_BASED_CLAUSE_DELETION
+#if CLAUSE_ACTIVITY
     void     claDecayActivity ();                      // Decay all clauses with the specified factor. Implemented by increasing the 'bump' value instead.
     void     claBumpActivity  (Clause& c);             // Increase a clause with the current 'bump' value.
 #endif
+#if TIERED_CLAUSE_DB
+    void     initTier         (Clause& c, int lbd);    // Set the LBD of a new learnt clause and place it in its tier.
+    bool     vivifyLearnts    ();                      // Strengthen the best learnt clauses by propagation (at level 0).
+#endif
 
     // Operations on clauses:
     //
@@ -306,6 +510,19 @@ protected:
 
     void     relocAll         (ClauseAllocator& to);
 
+    // Checkpoint contents (extended by subclasses):
+    //
+    virtual void writeState   (FILE* out);
+    virtual bool readState    (FILE* in);
+
+    template<class T> static void writeVal(FILE* out, const T& x)      { fwrite(&x, sizeof(T), 1, out); }
+    template<class T> static bool readVal (FILE* in, T& x)             { return fread(&x, sizeof(T), 1, in) == 1; }
+    template<class T> static void writeVec(FILE* out, const vec<T>& v) {
+        int n = v.size(); writeVal(out, n); if (n > 0) fwrite(&v[0], sizeof(T), n, out); }
+    template<class T> static bool readVec (FILE* in, vec<T>& v) {
+        int n; if (!readVal(in, n) || n < 0) return false;
+        v.clear(); v.growTo(n); return n == 0 || fread(&v[0], sizeof(T), n, in) == (size_t)n; }
+
     // Misc:
     //
     int      decisionLevel    ()      const; // Gives the current decisionlevel.
@@ -337,10 +554,39 @@ protected:
 inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
 
-inline void Solver::insertVarOrder(Var x) {
-    if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
+inline void Solver::saveBestPhase() {
+    if (trail.size() <= best_trail) return;
+    for (int i = 0; i < trail.size(); i++)
+        best_polarity[var(trail[i])] = sign(trail[i]);
+    best_trail = trail.size(); }
+
+#if STABLE_MODE
+inline void Solver::saveTargetPhase() {
+    if (trail.size() <= target_trail) return;
+    polarity.copyTo(target_polarity);
+    for (int i = 0; i < trail.size(); i++)
+        target_polarity[var(trail[i])] = sign(trail[i]);
+    target_trail = trail.size(); }
+#endif
 
-#if BRANCHING_HEURISTIC == VSIDS
+inline void Solver::insertVarOrder(Var x) {
+    if (vmtf && !stable){
+        if (queue_stamp[x] > queue_stamp[queue_search]) queue_search = x;
+    }else if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x, activity[x]); }
+
+inline void Solver::queueBump(Var x) {
+    QueueLink& l = queue_links[x];
+    if (l.next != var_Undef){
+        if (l.prev != var_Undef) queue_links[l.prev].next = l.next; else queue_first = l.next;
+        queue_links[l.next].prev = l.prev;
+        l.prev = queue_last;
+        l.next = var_Undef;
+        queue_links[queue_last].next = x;
+        queue_last = x; }
+    queue_stamp[x] = ++queue_stamps;
+    if (value(x) == l_Undef) queue_search = x; }
+
+#if BRANCHING_HEURISTIC == VSIDS || STABLE_MODE
 inline void Solver::varDecayActivity() { var_inc *= (1 / var_decay); }
 inline void Solver::varBumpActivity(Var v) { varBumpActivity(v, var_inc); }
 inline void Solver::varBumpActivity(Var v, double inc) {
@@ -348,13 +594,14 @@ inline void Solver::varBumpActivity(Var v, double inc) {
         // Rescale:
         for (int i = 0; i < nVars(); i++)
             activity[i] *= 1e-100;
+        order_heap.scale(1e-100);
         var_inc *= 1e-100; }
 
     // Update order_heap with respect to new activity:
     if (order_heap.inHeap(v))
-        order_heap.decrease(v); }
+        order_heap.update(v, activity[v]); }
 #endif
-#if ! LBD_BASED_CLAUSE_DELETION
+#if CLAUSE_ACTIVITY
 inline void Solver::claDecayActivity() { cla_inc *= (1 / clause_decay); }
 inline void Solver::claBumpActivity (Clause& c) {
         if ( (c.activity() += cla_inc) > 1e20 ) {
@@ -363,11 +610,23 @@ inline void Solver::claBumpActivity (Clause& c) {
                 ca[learnts[i]].activity() *= 1e-20;
             cla_inc *= 1e-20; } }
 #endif
+#if TIERED_CLAUSE_DB
+inline void Solver::initTier(Clause& c, int l) {
+    c.lbd(l);
+    c.tier(l <= core_lbd ? TIER_CORE : l <= tier2_lbd ? TIER_MID : TIER_LOCAL);
+    c.touched() = conflicts;
+    claBumpActivity(c); }
+#endif
 
 inline void Solver::checkGarbage(void){ return checkGarbage(garbage_frac); }
 inline void Solver::checkGarbage(double gf){
-    if (ca.wasted() > ca.size() * gf)
-        garbageCollect(); }
+    if (ca.wasted() > ca.size() * gf){
+        TIMER_START(T_GC);
+        double   start  = trace.enabled() ? realTime() : 0;
+        uint32_t before = ca.size();
+        garbageCollect();
+        if (trace.enabled()) trace.complete(EventTrace::GC, start, before, ca.size());
+        TIMER_STOP(T_GC); } }
 
 // NOTE: enqueue does not set the ok flag! (only public methods do)
 inline bool     Solver::enqueue         (Lit p, CRef from)      { return value(p) != l_Undef ? value(p) != l_False : (uncheckedEnqueue(p, from), true); }
@@ -376,7 +635,16 @@ inline bool     Solver::addEmptyClause  ()                      { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p)                 { add_tmp.clear(); add_tmp.push(p); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
-inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; }
+inline bool     Solver::locked          (const Clause& c) const {
+    int i = c.size() != 2 ? 0 : (value(c[0]) == l_True ? 0 : 1);   // (binary reasons are not reordered by 'propagate()')
+    return value(c[i]) == l_True && reason(var(c[i])) != CRef_Undef && ca.lea(reason(var(c[i]))) == &c; }
+// Imported clauses count as useful the first time they imply a literal or take part in a conflict:
+inline void     Solver::markSharedUsed  (Clause& c) { if (c.shared() == 1){ c.update_shared(2); nSharedsUSed++; } }
+inline Clause&  Solver::reasonClause    (Var x) {
+    Clause& c = ca[reason(x)];
+    if (c.size() == 2 && value(c[0]) == l_False){
+        Lit tmp = c[0]; c[0] = c[1], c[1] = tmp; }
+    return c; }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
@@ -403,6 +671,7 @@ inline void     Solver::setConfBudget(int64_t x){ conflict_budget    = conflicts
 inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagations + x; }
 inline void     Solver::interrupt(){ asynch_interrupt = true; }
 inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
+inline void     Solver::requestCheckpoint(){ checkpoint_requested = true; }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
 inline bool     Solver::withinBudget() const {
     return !asynch_interrupt &&
@@ -38,6 +38,18 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
     #define RAPID_DELETION true //modified initially true
 #endif
 
+// Three-tier learnt clause database (see 'Solver::reduceDB()'). It refines LBD_BASED_CLAUSE_DELETION
+// and replaces RAPID_DELETION, which only applies without it:
+#ifndef TIERED_CLAUSE_DB
+    #define TIERED_CLAUSE_DB true
+#endif
+#if TIERED_CLAUSE_DB && ! LBD_BASED_CLAUSE_DELETION
+    #error TIERED_CLAUSE_DB requires LBD_BASED_CLAUSE_DELETION
+#endif
+
+// Learnt clauses have a bumped activity, unless they are deleted by LBD alone:
+#define CLAUSE_ACTIVITY (! LBD_BASED_CLAUSE_DELETION || TIERED_CLAUSE_DB)
+
 #ifndef ALMOST_CONFLICT
     #define ALMOST_CONFLICT true //modified initially true
 #endif
@@ -52,6 +64,14 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
     #error ANTI_EXPLORATION requires BRANCHING_HEURISTIC == LRB
 #endif
 
+// Alternation of the LRB search with a stable mode on VSIDS and target phases (see 'Solver::switchMode()'):
+#ifndef STABLE_MODE
+    #define STABLE_MODE true
+#endif
+#if STABLE_MODE && BRANCHING_HEURISTIC != LRB
+    #error STABLE_MODE requires BRANCHING_HEURISTIC == LRB
+#endif
+
 //added by @lavleshm
 #ifndef CLAUSE_TRACKING
     #define CLAUSE_TRACKING false
@@ -59,6 +79,37 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef SHARED_CLAUSE_USE_PER
     #define SHARED_CLAUSE_USE_PER false
 #endif
+
+// Per-phase timers in the search loop (see 'Solver::timer_ticks'):
+#ifndef SEARCH_TIMERS
+    #define SEARCH_TIMERS false
+#endif
+
+// Children per node of the decision heap 'Solver::order_heap' (see 'DaryHeap'):
+#ifndef ORDER_HEAP_ARITY
+    #define ORDER_HEAP_ARITY 4
+#endif
+#if ORDER_HEAP_ARITY < 2
+    #error ORDER_HEAP_ARITY must be at least 2
+#endif
+
+// Watchers ahead of the current one whose clause 'propagate()' prefetches (0 = no prefetching). Off
+// by default: on 'maplesat-microbench' the prefetch made 'propagate()' slower at every distance tried:
+#ifndef PREFETCH_DISTANCE
+    #define PREFETCH_DISTANCE 0
+#endif
+
+// Clauses of at least this size remember where 'propagate()' last found a replacement watch, and
+// resume the next search from there (0 = never):
+#ifndef SCAN_POS_MIN_SIZE
+    #define SCAN_POS_MIN_SIZE 10
+#endif
+
+// Whether those searches test 8 literals at a time, with an AVX2 gather from a packed copy of the
+// assignment ('Solver::false_lits'). AVX2 is checked at run time, falling back to the scalar search:
+#ifndef VECTOR_WATCH_SCAN
+    #define VECTOR_WATCH_SCAN false
+#endif
 //------------------------------------------------------------------------------------------------------------------
 
 #include <assert.h>
@@ -81,10 +132,10 @@ namespace Minisat {
 typedef int Var;
 #define var_Undef (-1)
 
-#if LBD_BASED_CLAUSE_DELETION
-typedef int Act;
-#else
+#if CLAUSE_ACTIVITY
 typedef float Act;
+#else
+typedef int Act;
 #endif
 
 struct Lit {
@@ -164,6 +215,9 @@ inline lbool toLbool(int   v) { return lbool((uint8_t)v);  }
 class Clause;
 typedef RegionAllocator<uint32_t>::Ref CRef;
 
+// Tiers of the learnt clause database (with TIERED_CLAUSE_DB):
+enum { TIER_CORE, TIER_MID, TIER_LOCAL };
+
 class Clause {
     struct {
         unsigned mark      : 2;
@@ -171,11 +225,15 @@ class Clause {
         unsigned shared    : 2; //added by @lavleshm
         unsigned has_extra : 1;
         unsigned reloced   : 1;
-        unsigned size      : 25; }                            header;
-    union { Lit lit; Act act; uint32_t abs; CRef rel; } data[0];
+        unsigned has_pos   : 1;
+        unsigned size      : 24; }                            header;
+    union { Lit lit; Act act; uint32_t abs; CRef rel; uint32_t pos; uint32_t touched; uint32_t lbd_tier; } data[0];
 
     friend class ClauseAllocator;
 
+    // Index of the first word after the literals and the extra fields:
+    int endOfExtra() const { return header.size + header.has_extra + (TIERED_CLAUSE_DB && header.learnt ? 2 : 0); }
+
     /**
     * modified by @lavleshm
     * Adding variable to identify shared clauses, constructor is also modified(the original is commented below)
@@ -184,12 +242,13 @@ class Clause {
 
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
     template<class V>
-    Clause(const V& ps, bool use_extra, bool learnt, int shared) {
+    Clause(const V& ps, bool use_extra, bool learnt, int shared, bool use_pos) {
         header.mark      = 0;
         header.learnt    = learnt;
         header.shared    = shared; //added by @lavleshm
         header.has_extra = use_extra;
         header.reloced   = 0;
+        header.has_pos   = use_pos;
         header.size      = ps.size();
 
 
@@ -202,6 +261,14 @@ class Clause {
             else
                 calcAbstraction();
         }
+#if TIERED_CLAUSE_DB
+        if (header.learnt){
+            data[header.size + 1].touched  = 0;
+            data[header.size + 2].lbd_tier = TIER_LOCAL;
+        }
+#endif
+        if (header.has_pos)
+            data[endOfExtra()].pos = 2;
     }
 
     //***********************************************************************************************
@@ -236,12 +303,16 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size());
+                                               for (int k = 0; k < trailingWords(); k++) data[header.size-i+k] = data[header.size+k];
+                                               header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     int          shared      ()      const   { return header.shared;} //added by @lavleshm
     void         update_shared(int value)    { header.shared = value;}
     bool         has_extra   ()      const   { return header.has_extra; }
+    bool         has_pos     ()      const   { return header.has_pos; }
+    int          trailingWords()     const   { return endOfExtra() - header.size + header.has_pos; }  // Words after the literals.
     uint32_t     mark        ()      const   { return header.mark; }
     void         mark        (uint32_t m)    { header.mark = m; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
@@ -258,6 +329,18 @@ public:
 
     Act&         activity    ()              { assert(header.has_extra); return data[header.size].act; }
     uint32_t     abstraction () const        { assert(header.has_extra); return data[header.size].abs; }
+    uint32_t&    scanPos     ()              { assert(header.has_pos); return data[endOfExtra()].pos; }  // Not necessarily below 'size()'.
+
+#if TIERED_CLAUSE_DB
+    // Learnt clauses only:
+    uint32_t&    touched     ()              { assert(header.learnt); return data[header.size + 1].touched; }  // Conflict count of the last use.
+    int          lbd         ()      const   { assert(header.learnt); return data[header.size + 2].lbd_tier >> 3; }
+    void         lbd         (int l)         { assert(header.learnt); data[header.size + 2].lbd_tier = (l << 3) | (data[header.size + 2].lbd_tier & 7); }
+    int          tier        ()      const   { assert(header.learnt); return data[header.size + 2].lbd_tier & 3; }
+    void         tier        (int t)         { assert(header.learnt); data[header.size + 2].lbd_tier = (data[header.size + 2].lbd_tier & ~3u) | t; }
+    bool         vivified    ()      const   { assert(header.learnt); return data[header.size + 2].lbd_tier & 4; }
+    void         vivified    (bool b)        { assert(header.learnt); data[header.size + 2].lbd_tier = (data[header.size + 2].lbd_tier & ~4u) | (b << 2); }
+#endif
 
     Lit          subsumes    (const Clause& other) const;
     void         strengthen  (Lit p);
@@ -271,8 +354,8 @@ public:
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
 class ClauseAllocator : public RegionAllocator<uint32_t>
 {
-    static int clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    static int clauseWord32Size(int size, int trailing_words){
+        return (sizeof(Clause) + (sizeof(Lit) * (size + trailing_words))) / sizeof(uint32_t); }
  public:
     bool extra_clause_field;
 
@@ -289,9 +372,12 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
         bool use_extra = learnt | extra_clause_field;
+        bool use_pos   = SCAN_POS_MIN_SIZE > 0 && ps.size() >= SCAN_POS_MIN_SIZE;
+
+        int  trailing  = (int)use_extra + (TIERED_CLAUSE_DB && learnt ? 2 : 0) + (int)use_pos;
 
-        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra));
-        new (lea(cid)) Clause(ps, use_extra, learnt, shared);
+        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), trailing));
+        new (lea(cid)) Clause(ps, use_extra, learnt, shared, use_pos);
 
         return cid;
     }
@@ -306,7 +392,7 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra()));
+        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.trailingWords()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -315,14 +401,20 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         
         if (c.reloced()) { cr = c.relocation(); return; }
         
-        cr = to.alloc(c, c.learnt());
+        cr = to.alloc(c, c.learnt(), c.shared());
         c.relocate(cr);
         
         // Copy extra data-fields: 
         // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
         to[cr].mark(c.mark());
         if (to[cr].learnt())         to[cr].activity() = c.activity();
+#if TIERED_CLAUSE_DB
+        if (to[cr].learnt()){
+            to[cr].touched() = c.touched();
+            to[cr].lbd(c.lbd()); to[cr].tier(c.tier()); to[cr].vivified(c.vivified()); }
+#endif
         else if (to[cr].has_extra()) to[cr].calcAbstraction();
+        if (to[cr].has_pos() && c.has_pos()) to[cr].scanPos() = c.scanPos();
     }
 };
 
@@ -0,0 +1,100 @@
+/*****************************************************************************************[Trace.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_Trace_h
+#define Minisat_Trace_h
+
+#include <stdio.h>
+
+#include "../mtl/Vec.h"
+#include "../utils/System.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// EventTrace -- a ring buffer of timestamped solver events:
+//
+// Only the most recent 'capacity' events are kept. The buffer is written in the Chrome trace event
+// format (loadable in chrome://tracing and Perfetto), with one process per rank. Timestamps are
+// wall-clock so that the events of ranks on different hosts line up in one timeline.
+
+class EventTrace {
+public:
+    enum Kind { Export, Import, Restart, ReduceDB, GC, PhaseShare, Terminate, NKinds };
+
+    struct Event {
+        double ts;      // Start, in seconds.
+        double dur;     // Duration in seconds, or negative for an instant event.
+        int    kind;
+        int    a, b, c; // Kind-specific arguments (see 'argNames()').
+    };
+
+    EventTrace() : head(0), total(0) {}
+
+    void init      (int capacity) { events.clear(); events.growTo(capacity); head = 0; total = 0; }
+    bool enabled   () const       { return events.size() > 0; }
+
+    void instant   (Kind k, int a = 0, int b = 0, int c = 0)                { push(k, realTime(), -1, a, b, c); }
+    void complete  (Kind k, double start, int a = 0, int b = 0, int c = 0)  { push(k, start, realTime() - start, a, b, c); }
+
+    int          size      ()      const { return total < (uint64_t)events.size() ? (int)total : events.size(); }
+    uint64_t     dropped   ()      const { return total - size(); }
+    const Event& operator[](int i) const { return events[(head - size() + i + events.size()) % events.size()]; }  // Oldest first.
+
+    static const char* name(int k) {
+        static const char* names[NKinds] = { "export", "import", "restart", "reduceDB", "gc", "phase_share", "terminate" };
+        return names[k]; }
+
+    static void argNames(int k, const char*& a, const char*& b, const char*& c) {
+        static const char* names[NKinds][3] = {
+            { "size", NULL, NULL },                   { "received", "accepted", "rejected" },
+            { "conflicts", NULL, NULL },              { "learnts_before", "learnts_after", NULL },
+            { "words_before", "words_after", NULL },  { "trail", "imported", NULL },
+            { "result", "interrupted", NULL } };
+        a = names[k][0]; b = names[k][1]; c = names[k][2]; }
+
+    // Writes 'n' events as comma-separated trace event objects, with 't0' as the time origin:
+    static void writeEvents(FILE* out, const Event* es, int n, int pid, double t0, bool& first) {
+        for (int i = 0; i < n; i++){
+            const Event& e = es[i];
+            const char *na, *nb, *nc;
+            argNames(e.kind, na, nb, nc);
+            fprintf(out, "%s\n{\"name\": \"%s\", \"pid\": %d, \"tid\": 0, \"ts\": %.1f", first ? "" : ",", name(e.kind), pid, (e.ts - t0) * 1e6);
+            if (e.dur < 0) fprintf(out, ", \"ph\": \"i\", \"s\": \"p\"");
+            else           fprintf(out, ", \"ph\": \"X\", \"dur\": %.1f", e.dur * 1e6);
+            fprintf(out, ", \"args\": {\"%s\": %d", na, e.a);
+            if (nb) fprintf(out, ", \"%s\": %d", nb, e.b);
+            if (nc) fprintf(out, ", \"%s\": %d", nc, e.c);
+            fprintf(out, "}}");
+            first = false; } }
+
+private:
+    vec<Event> events;
+    int        head;    // Position of the next event in 'events'.
+    uint64_t   total;   // Number of events recorded, including the overwritten ones.
+
+    void push(Kind k, double ts, double dur, int a, int b, int c) {
+        Event& e = events[head];
+        e.ts = ts; e.dur = dur; e.kind = k; e.a = a; e.b = b; e.c = c;
+        if (++head == events.size()) head = 0;
+        total++; }
+};
+
+//=================================================================================================
+}
+
+#endif
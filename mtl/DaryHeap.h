@@ -0,0 +1,194 @@
+/***************************************************************************************[DaryHeap.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_DaryHeap_h
+#define Minisat_DaryHeap_h
+
+#include "../mtl/Vec.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// A d-ary heap of (key, integer) pairs with support for changing keys, one by one or in batches.
+//
+// Unlike 'Heap', the comparator sees the keys, which are stored with the integers, so comparisons
+// read consecutive memory: the D children of a node are adjacent (with D = 4 and 'double' keys they
+// fill one cache line), and the tree is shallower than a binary one. The owner must pass every
+// change of a key to the heap.
+
+
+template<class K, class Comp, int D = 4>
+class DaryHeap {
+    struct Elem { K key; int n; };
+
+    Comp      lt;       // The heap is a minimum-heap with respect to this comparator on the keys
+    vec<Elem> heap;     // Heap of (key, integer) pairs
+    vec<int>  indices;  // Each integers position (index) in the Heap
+    vec<Elem> pending;  // Key changes of 'set()' not applied yet
+
+    // Index "traversal" functions
+    static inline int child (int i) { return i*D+1; }    // (the first one)
+    static inline int parent(int i) { return (i-1) / D; }
+
+
+    void percolateUp(int i)
+    {
+        Elem x = heap[i];
+        int  p = parent(i);
+
+        while (i != 0 && lt(x.key, heap[p].key)){
+            heap[i]            = heap[p];
+            indices[heap[i].n] = i;
+            i                  = p;
+            p                  = parent(p);
+        }
+        heap   [i]   = x;
+        indices[x.n] = i;
+    }
+
+
+    void percolateDown(int i)
+    {
+        Elem x = heap[i];
+        for (int c = child(i); c < heap.size(); c = child(i)){
+            int end  = c + D < heap.size() ? c + D : heap.size();
+            int best = c;
+            for (c++; c < end; c++)
+                if (lt(heap[c].key, heap[best].key)) best = c;
+            if (!lt(heap[best].key, x.key)) break;
+            heap[i]            = heap[best];
+            indices[heap[i].n] = i;
+            i                  = best;
+        }
+        heap   [i]   = x;
+        indices[x.n] = i;
+    }
+
+
+    void heapify()
+    {
+        for (int i = heap.size() > 1 ? parent(heap.size() - 1) : -1; i >= 0; i--)
+            percolateDown(i);
+    }
+
+
+  public:
+    DaryHeap(const Comp& c = Comp()) : lt(c) { }
+
+    int  size      ()          const { return heap.size(); }
+    bool empty     ()          const { return heap.size() == 0; }
+    bool inHeap    (int n)     const { return n < indices.size() && indices[n] >= 0; }
+    int  operator[](int index) const { assert(index < heap.size()); return heap[index].n; }
+
+
+    // Change the key of 'n', or insert it:
+    void update(int n, K key)
+    {
+        if (!inHeap(n))
+            insert(n, key);
+        else {
+            int i = indices[n];
+            K   old = heap[i].key;
+            heap[i].key = key;
+            if (lt(key, old)) percolateUp(i);
+            else              percolateDown(i); }
+    }
+
+
+    // Batched variant of 'update()' for elements in the heap: the changes take effect on 'settle()'.
+    // A batch of more than an eighth of the heap is applied by rebuilding it, in linear time:
+    void set(int n, K key)
+    {
+        assert(inHeap(n));
+        Elem e = { key, n };
+        pending.push(e);
+    }
+
+    void settle()
+    {
+        if (pending.size() * 8 > heap.size()){
+            for (int i = 0; i < pending.size(); i++)
+                if (inHeap(pending[i].n))
+                    heap[indices[pending[i].n]].key = pending[i].key;
+            heapify();
+        }else
+            for (int i = 0; i < pending.size(); i++)
+                if (inHeap(pending[i].n))
+                    update(pending[i].n, pending[i].key);
+        pending.clear();
+    }
+
+
+    // Multiply all keys by 'f' (which must keep their order):
+    void scale(K f)
+    {
+        for (int i = 0; i < heap.size(); i++)    heap[i].key    *= f;
+        for (int i = 0; i < pending.size(); i++) pending[i].key *= f;
+    }
+
+
+    void insert(int n, K key)
+    {
+        indices.growTo(n+1, -1);
+        assert(!inHeap(n));
+
+        Elem e = { key, n };
+        indices[n] = heap.size();
+        heap.push(e);
+        percolateUp(indices[n]);
+    }
+
+
+    int  removeMin()
+    {
+        int x              = heap[0].n;
+        heap[0]            = heap.last();
+        indices[heap[0].n] = 0;
+        indices[x]         = -1;
+        heap.pop();
+        if (heap.size() > 1) percolateDown(0);
+        return x;
+    }
+
+
+    // Rebuild the heap from scratch, using the elements in 'ns' and their keys in 'keys':
+    void build(const vec<int>& ns, const vec<K>& keys) {
+        clear();
+
+        for (int i = 0; i < ns.size(); i++){
+            Elem e = { keys[ns[i]], ns[i] };
+            indices.growTo(ns[i]+1, -1);
+            indices[ns[i]] = i;
+            heap.push(e); }
+
+        heapify();
+    }
+
+    void clear(bool dealloc = false)
+    {
+        for (int i = 0; i < heap.size(); i++)
+            indices[heap[i].n] = -1;
+        heap.clear(dealloc);
+        pending.clear(dealloc);
+    }
+};
+
+
+//=================================================================================================
+}
+
+#endif
@@ -23,6 +23,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <signal.h>
 #include <zlib.h>
 #include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include <mpi.h>
 #include <fstream>
 #include "../utils/System.h"
@@ -65,6 +67,181 @@ void printStats(Solver& solver)
 #else
     printf("CPU time: %g s ", cpu_time);
 #endif
+#if SEARCH_TIMERS
+    for (int t = 0; t < Solver::T_NTIMERS; t++)
+        printf("%s: %.3f s ", Solver::timer_names[t], solver.timerSeconds(t));
+#endif
+}
+
+
+//=================================================================================================
+// Aggregated statistics:
+//
+// Every rank contributes one row of counters and measurements. Rank 0 gathers the rows and writes
+// a single JSON report with the per-rank rows and the totals over all ranks.
+
+static const char* stat_counters[] = {
+    "conflicts", "decisions", "propagations", "restarts",
+    "clauses_exported", "clauses_received", "clauses_imported", "shared_tracked", "shared_used",
+    "phase_exports", "phase_imports", "epochs", "chrono_backtracks", "reused_levels",
+    "vivified_clauses", "vivified_literals", "binmin_literals", "blocked_restarts", "mode_switches",
+    "rephases", "walk_flips"
+#if SEARCH_TIMERS
+  , "calls_import", "calls_export", "calls_propagate", "calls_analyze", "calls_reducedb", "calls_simplify", "calls_gc"
+#endif
+    };
+
+// Measurements are summed in the totals if 'summed', otherwise the maximum is taken. The first
+// 'n_main_measures' are supplied by the caller, the others are taken from the solver:
+static const int n_main_measures = 6;
+static const struct { const char* name; bool summed; } stat_measures[] = {
+    { "cpu_time", true }, { "wall_time", false }, { "parse_time", false }, { "simplify_time", false },
+    { "solve_time", false }, { "mem_peak_mb", true }, { "epoch_sync_time", true }
+#if SEARCH_TIMERS
+  , { "time_import", true }, { "time_export", true }, { "time_propagate", true }, { "time_analyze", true },
+    { "time_reducedb", true }, { "time_simplify", true }, { "time_gc", true }
+#endif
+    };
+
+static const int n_stat_counters = sizeof(stat_counters) / sizeof(*stat_counters);
+static const int n_stat_measures = sizeof(stat_measures) / sizeof(*stat_measures);
+
+static const char* resultName(int status) { return status == 10 ? "SAT" : status == 20 ? "UNSAT" : "INDET"; }
+
+static void printJsonRow(FILE* out, const uint64_t* counters, const double* measures)
+{
+    for (int i = 0; i < n_stat_counters; i++)
+        fprintf(out, ", \"%s\": %" PRIu64, stat_counters[i], counters[i]);
+    for (int i = 0; i < n_stat_measures; i++)
+        fprintf(out, ", \"%s\": %.6g", stat_measures[i].name, measures[i]);
+
+    // Usefulness of imported clauses is only known when they are tracked (see 'CLAUSE_TRACKING'):
+    if (counters[7] > 0) fprintf(out, ", \"import_use_pct\": %.2f", counters[8] * 100.0 / counters[7]);
+    else                 fprintf(out, ", \"import_use_pct\": null");
+}
+
+// Collective: must be called by all ranks.
+static void writeStatsJson(Solver& S, const char* file, const char* instance, int status, const double* measures)
+{
+    uint64_t counters[n_stat_counters] = {
+        S.conflicts, S.decisions, S.propagations, S.starts,
+        S.clauses_exported, S.clauses_received, S.clauses_imported, (uint64_t)S.nShareds, (uint64_t)S.nSharedsUSed,
+        S.phase_exports, S.phase_imports, S.det_epochs, S.chrono_backtracks, S.reused_levels,
+        S.vivified_clauses, S.vivified_lits, S.bin_min_lits, S.blocked_restarts, S.mode_switches,
+        S.rephases, S.walk_flips };
+    double   row[n_stat_measures];
+    for (int i = 0; i < n_main_measures; i++)
+        row[i] = measures[i];
+    row[n_main_measures] = S.det_sync_time;
+#if SEARCH_TIMERS
+    for (int t = 0; t < Solver::T_NTIMERS; t++){
+        counters[n_stat_counters - Solver::T_NTIMERS + t] = S.timer_calls[t];
+        row     [n_main_measures + 1 + t]                 = S.timerSeconds(t); }
+#endif
+
+    int           n = S.Mpi_rank == 0 ? S.Comm_size : 0;
+    vec<uint64_t> all_counters(n * n_stat_counters);
+    vec<double>   all_measures(n * n_stat_measures);
+    vec<int>      all_status  (n);
+    MPI_Gather(counters, n_stat_counters, MPI_UINT64_T, (uint64_t*)all_counters, n_stat_counters, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    MPI_Gather(row, n_stat_measures, MPI_DOUBLE, (double*)all_measures, n_stat_measures, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Gather(&status, 1, MPI_INT, (int*)all_status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (S.Mpi_rank != 0) return;
+
+    FILE* out = fopen(file, "wb");
+    if (out == NULL){
+        fprintf(stderr, "WARNING! Could not write statistics to: %s\n", file);
+        return; }
+
+    // Totals, and the answer of any rank that found one:
+    uint64_t total_counters[n_stat_counters] = { 0 };
+    double   total_measures[n_stat_measures] = { 0 };
+    int      total_status = 0;
+    for (int r = 0; r < n; r++){
+        for (int i = 0; i < n_stat_counters; i++)
+            total_counters[i] += all_counters[r * n_stat_counters + i];
+        for (int i = 0; i < n_stat_measures; i++){
+            double m = all_measures[r * n_stat_measures + i];
+            total_measures[i] = stat_measures[i].summed ? total_measures[i] + m : (m > total_measures[i] ? m : total_measures[i]); }
+        if (all_status[r] != 0) total_status = all_status[r];
+    }
+
+    fprintf(out, "{\n  \"instance\": \"");
+    for (const char* c = instance; *c; c++)
+        fprintf(out, (*c == '"' || *c == '\\') ? "\\%c" : "%c", *c);
+    fprintf(out, "\",\n  \"ranks\": %d,\n  \"result\": \"%s\",\n", n, resultName(total_status));
+    fprintf(out, "  \"totals\": {\"result\": \"%s\"", resultName(total_status));
+    printJsonRow(out, total_counters, total_measures);
+    fprintf(out, "},\n  \"per_rank\": [\n");
+    for (int r = 0; r < n; r++){
+        fprintf(out, "    {\"rank\": %d, \"result\": \"%s\"", r, resultName(all_status[r]));
+        printJsonRow(out, &all_counters[r * n_stat_counters], &all_measures[r * n_stat_measures]);
+        fprintf(out, "}%s\n", r + 1 < n ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    fclose(out);
+}
+
+
+//=================================================================================================
+// Event trace:
+//
+// Rank 0 collects the event buffers of all ranks, one rank at a time, and writes them as one Chrome
+// trace (one process per rank), with the earliest start of any rank as the time origin.
+
+// Collective: must be called by all ranks.
+static void writeTrace(Solver& S, const char* file, double start)
+{
+    // Events travel as one MPI type, so that the counts fit in an 'int' for any 'trace-size':
+    MPI_Datatype event_type;
+    MPI_Type_contiguous(sizeof(EventTrace::Event), MPI_BYTE, &event_type);
+    MPI_Type_commit(&event_type);
+
+    vec<EventTrace::Event> events;
+    for (int i = 0; i < S.trace.size(); i++)
+        events.push(S.trace[i]);
+
+    int           n = S.Mpi_rank == 0 ? S.Comm_size : 0;
+    int           count = events.size();
+    uint64_t      dropped = S.trace.dropped();
+    double        t0 = start;
+    vec<int>      all_counts(n);
+    vec<uint64_t> all_dropped(n);
+    MPI_Gather(&count, 1, MPI_INT, (int*)all_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Gather(&dropped, 1, MPI_UINT64_T, (uint64_t*)all_dropped, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&start, &t0, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+
+    // Rank 0 receives and writes the events of one rank at a time, never holding all of them:
+    if (S.Mpi_rank != 0){
+        MPI_Send((EventTrace::Event*)events, count, event_type, 0, TAG_TRACE, MPI_COMM_WORLD);
+        MPI_Type_free(&event_type);
+        return; }
+
+    FILE* out = fopen(file, "wb");
+    if (out == NULL)
+        fprintf(stderr, "WARNING! Could not write trace to: %s\n", file);
+    else
+        fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+
+    bool first = true;
+    for (int r = 0; r < n; r++){
+        if (r > 0){
+            events.clear();
+            events.growTo(all_counts[r]);
+            MPI_Recv((EventTrace::Event*)events, all_counts[r], event_type, r, TAG_TRACE, MPI_COMM_WORLD, MPI_STATUS_IGNORE); }
+        if (out == NULL) continue;
+        fprintf(out, "%s\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"rank %d\"}}", first ? "" : ",", r, r);
+        first = false;
+        EventTrace::writeEvents(out, (const EventTrace::Event*)events, events.size(), r, t0, first);
+    }
+    MPI_Type_free(&event_type);
+    if (out == NULL) return;
+
+    fprintf(out, "\n],\n\"otherData\": {\"dropped_events\": [");
+    for (int r = 0; r < n; r++)
+        fprintf(out, "%s%" PRIu64, r > 0 ? ", " : "", all_dropped[r]);
+    fprintf(out, "]}}\n");
+    fclose(out);
 }
 
 
@@ -73,6 +250,9 @@ static Solver* solver;
 // for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
 static void SIGINT_interrupt(int signum) { solver->interrupt(); }
 
+// Ask the solver to write a checkpoint at its next restart:
+static void SIGUSR1_checkpoint(int signum) { solver->requestCheckpoint(); }
+
 // Note that '_exit()' rather than 'exit()' has to be used. The reason is that 'exit()' calls
 // destructors and may cause deadlocks if a malloc/free function happens to be running (these
 // functions are guarded by locks for multithreaded use).
@@ -84,6 +264,197 @@ static void SIGINT_exit(int signum) {
     _exit(1); }
 
 
+//=================================================================================================
+// Server mode:
+//
+// The solver stays resident and answers queries from one client at a time on a Unix domain
+// socket. Requests and replies are single lines, literals are in DIMACS notation:
+//
+//   add <lits> 0      Add a clause.                            -> "ok" | "unsat" | "error ..."
+//   solve <lits> 0    Solve under the given assumptions.       -> "SAT" | "UNSAT" | "INDET"
+//   model             Model of the last SAT answer.            -> "v <lits> 0"
+//   core              Failed assumptions of the last UNSAT.    -> "v <lits> 0"
+//   shutdown          Stop the server on all ranks.            -> "ok"
+//
+// Rank 0 owns the socket and broadcasts every request that changes the solver state, so all ranks
+// keep identical problems and learnt clauses stay valid across queries. The ranks race on each
+// query; the first one to finish interrupts the others and its model or core is sent to rank 0.
+
+// Parses the literals of a request up to the terminating 0. Fails on eliminated variables.
+static bool parseRequestLits(SimpSolver& S, const char* p, vec<Lit>& lits)
+{
+    lits.clear();
+    for (;;){
+        char* end;
+        long  x = strtol(p, &end, 10);
+        if (end == p) return false;
+        p = end;
+        if (x == 0) return true;
+        Var v = labs(x) - 1;
+        while (v >= S.nVars()) S.newVar();
+        if (S.isEliminated(v)) return false;
+        lits.push((x > 0) ? mkLit(v) : ~mkLit(v));
+    }
+}
+
+
+// Runs the solve request on all ranks and leaves the answer of the winning rank on rank 0.
+static lbool serveSolve(SimpSolver& S, const vec<Lit>& assumps)
+{
+    S.clearInterrupt();
+    lbool ret = S.solveLimited(assumps);
+    if (ret != l_Undef)
+        S.announceStop();
+
+    int status = ret == l_True ? 1 : ret == l_False ? 2 : 0;
+    vec<int> statuses(S.Comm_size);
+    MPI_Allgather(&status, 1, MPI_INT, (int*)statuses, 1, MPI_INT, MPI_COMM_WORLD);
+
+    int finished = 0, winner = -1;
+    for (int i = 0; i < S.Comm_size; i++)
+        if (statuses[i] != 0){
+            if (winner == -1) winner = i;
+            if (i != S.Mpi_rank) finished++; }
+    S.waitStops(finished);
+    if (winner == -1) return l_Undef;
+
+    // Transfer the model or final conflict to rank 0:
+    if (winner != 0 && (S.Mpi_rank == 0 || S.Mpi_rank == winner)){
+        vec<int> buf;
+        if (S.Mpi_rank == winner){
+            if (statuses[winner] == 1)
+                for (int i = 0; i < S.model.size(); i++) buf.push(toInt(S.model[i]));
+            else
+                for (int i = 0; i < S.conflict.size(); i++) buf.push(toInt(S.conflict[i]));
+            MPI_Send((int*)buf, buf.size(), MPI_INT, 0, TAG_RESULT, MPI_COMM_WORLD);
+        }else{
+            MPI_Status st;
+            int        len;
+            MPI_Probe(winner, TAG_RESULT, MPI_COMM_WORLD, &st);
+            MPI_Get_count(&st, MPI_INT, &len);
+            buf.growTo(len);
+            MPI_Recv((int*)buf, len, MPI_INT, winner, TAG_RESULT, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            if (statuses[winner] == 1){
+                S.model.clear();
+                for (int i = 0; i < len; i++) S.model.push(toLbool(buf[i]));
+            }else{
+                S.conflict.clear();
+                for (int i = 0; i < len; i++) S.conflict.push(toLit(buf[i]));
+            }
+        }
+    }
+
+    return statuses[winner] == 1 ? l_True : l_False;
+}
+
+
+// Executes one request on this rank. Only rank 0 passes a stream for the reply. Returns false
+// on 'shutdown'.
+static bool serveRequest(SimpSolver& S, const char* line, FILE* out, lbool& last)
+{
+    vec<Lit> lits;
+    if (strncmp(line, "add", 3) == 0){
+        if (!parseRequestLits(S, line + 3, lits)){
+            if (out) fprintf(out, "error bad or eliminated literal\n");
+        }else{
+            bool ok = S.addClause_(lits);
+            if (out) fprintf(out, ok ? "ok\n" : "unsat\n"); }
+    }else if (strncmp(line, "solve", 5) == 0){
+        if (!parseRequestLits(S, line + 5, lits)){
+            if (out) fprintf(out, "error bad or eliminated literal\n");
+        }else{
+            last = serveSolve(S, lits);
+            if (out) fprintf(out, last == l_True ? "SAT\n" : last == l_False ? "UNSAT\n" : "INDET\n"); }
+    }else if (strncmp(line, "model", 5) == 0 && out){
+        if (last != l_True)
+            fprintf(out, "error no model\n");
+        else{
+            fprintf(out, "v");
+            for (int i = 0; i < S.model.size(); i++)
+                if (S.model[i] != l_Undef)
+                    fprintf(out, " %s%d", (S.model[i] == l_True) ? "" : "-", i+1);
+            fprintf(out, " 0\n"); }
+    }else if (strncmp(line, "core", 4) == 0 && out){
+        if (last != l_False)
+            fprintf(out, "error no core\n");
+        else{
+            fprintf(out, "v");
+            for (int i = 0; i < S.conflict.size(); i++)
+                fprintf(out, " %s%d", sign(S.conflict[i]) ? "" : "-", var(S.conflict[i])+1);
+            fprintf(out, " 0\n"); }
+    }else if (strncmp(line, "shutdown", 8) == 0){
+        if (out) fprintf(out, "ok\n");
+        return false;
+    }else if (out)
+        fprintf(out, "error unknown request\n");
+
+    if (out) fflush(out);
+    return true;
+}
+
+
+// Requests that change the solver state are executed on every rank.
+static bool isBroadcastRequest(const char* line)
+{
+    return strncmp(line, "add", 3) == 0 || strncmp(line, "solve", 5) == 0 || strncmp(line, "shutdown", 8) == 0;
+}
+
+
+static void broadcastRequest(std::string& line)
+{
+    int len = line.size();
+    MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    line.resize(len);
+    if (len > 0) MPI_Bcast(&line[0], len, MPI_CHAR, 0, MPI_COMM_WORLD);
+}
+
+
+static void runServer(SimpSolver& S, const char* path)
+{
+    S.peer_stop = true;
+    lbool last  = l_Undef;
+
+    if (S.Mpi_rank != 0){
+        for (std::string line;;){
+            broadcastRequest(line);
+            if (!serveRequest(S, line.c_str(), NULL, last)) return; }
+    }
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+    if (sock < 0 || bind(sock, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(sock, 1) != 0)
+        printf("ERROR! Could not listen on socket: %s\n", path), MPI_Abort(MPI_COMM_WORLD, 1);
+    if (S.verbosity > 0)
+        printf("|  Serving on %s\n", path), fflush(stdout);
+
+    for (bool running = true; running;){
+        int fd = accept(sock, NULL, NULL);
+        if (fd < 0) continue;
+        FILE* in  = fdopen(fd, "r");
+        FILE* out = fdopen(dup(fd), "w");
+
+        char*  buf = NULL;
+        size_t cap = 0;
+        while (running && getline(&buf, &cap, in) > 0){
+            std::string line(buf);
+            if (isBroadcastRequest(line.c_str()))
+                broadcastRequest(line);
+            running = serveRequest(S, line.c_str(), out, last);
+        }
+        free(buf);
+        fclose(in);
+        fclose(out);
+    }
+
+    close(sock);
+    unlink(path);
+}
+
+
 //=================================================================================================
 // Main:
 
@@ -106,6 +477,14 @@ int main(int argc, char** argv)
         StringOption assumptions ("MAIN", "assumptions", "If given, use the assumptions in the file.");
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
+        StringOption ckpt   ("MAIN", "ckpt",   "If given, each rank writes checkpoints to '<ckpt>.<rank>' on SIGUSR1 and every 'ckpt-int' seconds.");
+        IntOption    ckpt_int("MAIN", "ckpt-int","Wall-clock seconds between checkpoints (0=only on SIGUSR1).\n", 0, IntRange(0, INT32_MAX));
+        BoolOption   resume ("MAIN", "resume", "Resume the search from the checkpoint given by 'ckpt', if it exists.", false);
+        StringOption server ("MAIN", "server", "If given, keep the solver resident and serve queries on this Unix domain socket.");
+        StringOption stats_json("MAIN", "stats-json", "If given, rank 0 writes the statistics of all ranks to this file as JSON.");
+        StringOption trace  ("MAIN", "trace",  "If given, rank 0 writes the sharing/restart/reduceDB events of all ranks to this file (Chrome trace format).");
+        IntOption    trace_size("MAIN", "trace-size", "Number of most recent events kept per rank for 'trace'.\n", 1 << 18, IntRange(1, INT32_MAX));
+        StringOption freeze ("MAIN", "freeze", "In server mode, only the variables listed in this file are protected from elimination (default: all).");
 
         parseOptions(argc, argv, true);
         
@@ -117,6 +496,10 @@ int main(int argc, char** argv)
         MPI_Comm_size(MPI_COMM_WORLD, &S.Comm_size);
         MPI_Comm_rank(MPI_COMM_WORLD, &S.Mpi_rank);
         S.random_seed = S.Mpi_rank*S.random_seed + 273647;
+        // Without timing-dependent imports the ranks would search alike; the seeded initial
+        // activities keep them apart reproducibly:
+        if (S.det_epoch > 0 && S.Mpi_rank > 0)
+            S.rnd_init_act = true;
 //        MPI_Pcontrol(1);
 //        MPI_Pcontrol(2);
 //        S.rnd_init_act = true;
@@ -130,11 +513,17 @@ int main(int argc, char** argv)
 //        S.sc_string = (std::string)argv[1] + " ";
         S.nShareds = 0;
         S.nSharedsUSed = 0;
+        if (ckpt){
+            S.checkpoint_file = (std::string)(const char*)ckpt + "." + std::to_string(S.Mpi_rank);
+            S.checkpoint_int  = ckpt_int; }
+        if (trace)
+            S.trace.init(trace_size);
         //
 //        S.rnd_pol = true;
         /*-------------------------------------------------------------------------*/
 
         double      initial_time = cpuTime();
+        double      initial_wall = realTime();
 
         if (!pre) S.eliminate(true);
 
@@ -194,6 +583,23 @@ int main(int argc, char** argv)
         // voluntarily:
         signal(SIGINT, SIGINT_interrupt);
         signal(SIGXCPU,SIGINT_interrupt);
+        signal(SIGUSR1,SIGUSR1_checkpoint);
+
+        // Queries may refer to any variable unless told otherwise, so keep them from elimination:
+        if (server){
+            if (freeze){
+                FILE* freeze_file = fopen(freeze, "r");
+                if (freeze_file == NULL)
+                    printf("ERROR! Could not open file: %s\n", (const char*)freeze), exit(1);
+                int i;
+                while (fscanf(freeze_file, "%d", &i) == 1)
+                    if (i != 0 && abs(i) <= S.nVars())
+                        S.setFrozen(abs(i) - 1, true);
+                fclose(freeze_file);
+            }else
+                for (Var v = 0; v < S.nVars(); v++)
+                    S.setFrozen(v, true);
+        }
 
         S.eliminate(true);
         double simplified_time = cpuTime();
@@ -201,6 +607,12 @@ int main(int argc, char** argv)
             printf("|  Simplification time:  %12.2f s                                       |\n", simplified_time - parsed_time);
             printf("|                                                                             |\n"); }
 
+        if (server){
+            runServer(S, server);
+            MPI_Finalize();
+            exit(0);
+        }
+
         if (!S.okay()){
             if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
             if (S.verbosity > 0){
@@ -209,9 +621,28 @@ int main(int argc, char** argv)
                 printStats(S);
                 printf("\n"); }
             printf("UNSATISFIABLE\n");
+            if (stats_json){
+                double measures[] = { cpuTime(), realTime() - initial_wall, parsed_time - initial_time, simplified_time - parsed_time, 0, memUsedPeak() };
+                writeStatsJson(S, stats_json, argc == 1 ? "<stdin>" : argv[1], 20, measures); }
+            if (trace)
+                writeTrace(S, trace, initial_wall);
             exit(20);
         }
 
+        if (ckpt && resume){
+            FILE* ckpt_in = fopen(S.checkpoint_file.c_str(), "rb");
+            if (ckpt_in == NULL){
+                if (S.verbosity > 0)
+                    printf("|  No checkpoint %s, starting from scratch\n", S.checkpoint_file.c_str());
+            }else{
+                fclose(ckpt_in);
+                if (!S.readCheckpoint(S.checkpoint_file.c_str()))
+                    printf("ERROR! Could not resume from checkpoint: %s\n", S.checkpoint_file.c_str()), exit(1);
+                if (S.verbosity > 0)
+                    printf("|  Resumed from %s at %" PRIu64" conflicts\n", S.checkpoint_file.c_str(), S.conflicts);
+            }
+        }
+
         if (dimacs){
             if (S.verbosity > 0)
                 printf("==============================[ Writing DIMACS ]===============================\n");
@@ -238,7 +669,16 @@ int main(int argc, char** argv)
         for( int i = 0; i < dummy.size(); i++) {
             printf("%s%d\n", sign(dummy[i]) ? "-" : "", var(dummy[i]));
         }
-        lbool ret = S.solveLimited(dummy);
+        // Local search ranks never prove UNSAT, so with them the first rank that finishes stops the
+        // others, and rank 0 receives its answer:
+        bool  stop_peers = S.walkers > 0 && S.Comm_size > 1 && S.det_epoch == 0;
+        lbool ret;
+        if (stop_peers){
+            S.peer_stop = true;
+            ret = serveSolve(S, dummy);
+        }else
+            ret = S.solveLimited(dummy);
+        double solved_time = cpuTime();
 
 //        if (S.verbosity > 0){
 //            printStats(S);
@@ -250,6 +690,11 @@ int main(int argc, char** argv)
         printf("[Rank]: %d [Iterations]: %lld ",S.Mpi_rank, S.iterations);
         printf(ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
         fflush(stdin);
+        if (stats_json){
+            double measures[] = { solved_time, realTime() - initial_wall, parsed_time - initial_time, simplified_time - parsed_time, solved_time - simplified_time, memUsedPeak() };
+            writeStatsJson(S, stats_json, argc == 1 ? "<stdin>" : argv[1], ret == l_True ? 10 : ret == l_False ? 20 : 0, measures); }
+        if (trace)
+            writeTrace(S, trace, initial_wall);
 //        printf("%s\n", S.sc_string.c_str());
 //        std::ofstream fh;
 //        fh.open("scUse", std::ios::app);
@@ -266,6 +711,11 @@ int main(int argc, char** argv)
         //modified by @lavleshm
 
 //        printf(ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
+        // In deterministic mode only the lowest rank that finished writes the result, and with
+        // stopped peers only rank 0:
+        if (res != NULL && S.Comm_size > 1 && ((S.det_epoch > 0 && S.det_winner != S.Mpi_rank) || (stop_peers && S.Mpi_rank != 0))){
+            fclose(res);
+            res = NULL; }
         if (res != NULL){
             if (ret == l_True){
                 fprintf(res, "SAT\n");
@@ -523,6 +523,8 @@ bool SimpSolver::eliminateVar(Var v)
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+    if (watches_bin[ mkLit(v)].size() == 0) watches_bin[ mkLit(v)].clear(true);
+    if (watches_bin[~mkLit(v)].size() == 0) watches_bin[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
@@ -673,6 +675,32 @@ void SimpSolver::cleanUpClauses()
 }
 
 
+//=================================================================================================
+// Checkpointing methods:
+
+
+// Appends the elimination stack, which is needed to extend models of the simplified problem.
+void SimpSolver::writeState(FILE* out)
+{
+    Solver::writeState(out);
+    writeVal(out, eliminated_vars);
+    writeVec(out, elimclauses);
+    writeVec(out, frozen);
+    writeVec(out, eliminated);
+}
+
+
+// NOTE: only the state after simplification has been turned off (see 'eliminate()') can be restored.
+bool SimpSolver::readState(FILE* in)
+{
+    if (use_simplification || !Solver::readState(in))
+        return false;
+
+    return readVal(in, eliminated_vars) && readVec(in, elimclauses) && readVec(in, frozen) && readVec(in, eliminated)
+        && frozen.size() == nVars() && eliminated.size() == nVars();
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
@@ -159,6 +159,9 @@ class SimpSolver : public Solver {
     void          cleanUpClauses           ();
     bool          implied                  (const vec<Lit>& c);
     void          relocAll                 (ClauseAllocator& to);
+
+    void          writeState               (FILE* out);
+    bool          readState                (FILE* in);
 };
 
 
@@ -32,6 +32,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 namespace Minisat {
 
 static inline double cpuTime(void); // CPU-time in seconds.
+static inline double realTime(void); // Wall-clock time in seconds.
+static inline uint64_t cpuTicks(void); // Cheap monotonic tick counter (time-stamp counter where available).
 extern double memUsed();            // Memory in mega bytes (returns 0 for unsupported architectures).
 extern double memUsedPeak();        // Peak-memory in mega bytes (returns 0 for unsupported architectures).
 
@@ -44,6 +46,7 @@ extern double memUsedPeak();        // Peak-memory in mega bytes (returns 0 for
 #include <time.h>
 
 static inline double Minisat::cpuTime(void) { return (double)clock() / CLOCKS_PER_SEC; }
+static inline double Minisat::realTime(void) { return (double)time(NULL); }
 
 #else
 #include <sys/time.h>
@@ -55,6 +58,25 @@ static inline double Minisat::cpuTime(void) {
     getrusage(RUSAGE_SELF, &ru);
     return (double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1000000; }
 
+static inline double Minisat::realTime(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1000000; }
+
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static inline uint64_t Minisat::cpuTicks(void) { return __rdtsc(); }
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t Minisat::cpuTicks(void) { return __rdtsc(); }
+#else
+#include <time.h>
+static inline uint64_t Minisat::cpuTicks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec; }
 #endif
 
 #endif